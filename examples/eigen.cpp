@@ -0,0 +1,35 @@
+#define _USE_MATH_DEFINES
+#include <iostream>
+#include <cmath>
+#include <Eigen/Dense>
+#include "../matplotlibcpp.h"
+
+namespace plt = matplotlibcpp;
+
+int main()
+{
+    // Prepare data: one signal per row.
+    int n = 1000;
+    Eigen::RowVectorXd t = Eigen::RowVectorXd::LinSpaced(n, 0, 4*M_PI);
+    Eigen::MatrixXd signals(2, n);
+    signals.row(0) = t.array().sin();
+    signals.row(1) = t.array().cos();
+
+    // A row of a column-major matrix is strided, it is plotted without a copy.
+    plt::named_plot("sin", t, signals.row(0));
+
+    // Expressions are evaluated once, directly into the numpy array.
+    plt::named_plot("sin * cos", t, signals.row(0).cwiseProduct(signals.row(1)), "r--");
+
+    // float data stays float.
+    Eigen::VectorXf samples = Eigen::VectorXf::Random(50);
+    Eigen::VectorXf positions = Eigen::VectorXf::LinSpaced(50, 0, 4*M_PI);
+    plt::scatter(positions, samples, 10.0);
+
+    plt::title("Eigen data");
+    plt::legend();
+
+    const char* filename = "./eigen.png";
+    std::cout << "Saving result to " << filename << std::endl;
+    plt::save(filename);
+}
@@ -0,0 +1,56 @@
+#define _USE_MATH_DEFINES
+#include <iostream>
+#include <cmath>
+#include <chrono>
+#include "../matplotlibcpp.h"
+
+namespace plt = matplotlibcpp;
+
+int main()
+{
+    // A window of 100000 samples scrolling over a synthetic signal.
+    const size_t n = 100000;
+    const int frames = 50;
+    std::vector<double> x(n), y(n);
+    for (size_t i = 0; i < n; ++i) x[i] = i;
+
+    auto fill = [&](int frame) {
+        for (size_t i = 0; i < n; ++i)
+            y[i] = sin(2*M_PI*(i + 500*frame)/2000.0) + 0.1*sin(2*M_PI*(i + 500*frame)/37.0);
+    };
+
+    // Rebuilding the figure for every frame.
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        fill(frame);
+        plt::clf();
+        plt::named_plot("signal", x, y);
+        plt::title("clf() and plot()");
+        plt::legend();
+        plt::pause(0.001);
+    }
+    double rebuild = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    plt::clf();
+
+    // Creating the line once and updating it in place.
+    plt::Plot line("signal");
+    plt::xlim(0.0, (double)n);
+    plt::ylim(-1.2, 1.2);
+    plt::title("Plot::update() and Animation::redraw()");
+    plt::legend();
+
+    plt::Animation animation; // fixed limits, blitting if the backend supports it
+    animation.add(line);
+
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        fill(frame);
+        line.update(x, y);
+        animation.redraw();
+    }
+    double update = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "blitting: " << (animation.is_blitting() ? "yes" : "no") << std::endl;
+    std::cout << "frames per second with clf(): " << frames/rebuild << std::endl;
+    std::cout << "frames per second with update(): " << frames/update << std::endl;
+}
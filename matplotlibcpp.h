@@ -17,6 +17,11 @@
 #  include <numpy/arrayobject.h>
 #endif // WITHOUT_NUMPY
 
+// The Eigen overloads are available if Eigen is included before this header (or WITH_EIGEN is defined)
+#ifdef WITH_EIGEN
+#  include <Eigen/Core>
+#endif // WITH_EIGEN
+
 #if PY_MAJOR_VERSION >= 3
 #  define PyString_FromString PyUnicode_FromString
 #  define PyInt_FromLong PyLong_FromLong
@@ -71,6 +76,9 @@ struct _interpreter {
     PyObject *s_python_function_suptitle;
     PyObject *s_python_function_bar;
     PyObject *s_python_function_subplots_adjust;
+#if defined(WITHOUT_NUMPY) && PY_MAJOR_VERSION >= 3
+    PyObject *s_python_array_type;
+#endif
 
 
     /* For now, _interpreter is implemented as a singleton since its currently not possible to have
@@ -267,6 +275,15 @@ private:
         ) { throw std::runtime_error("Python object is unexpectedly not a PyFunction."); }
 
         s_python_empty_tuple = PyTuple_New(0);
+
+#if defined(WITHOUT_NUMPY) && PY_MAJOR_VERSION >= 3
+        // array.array is the container of the data passed to matplotlib (see get_array)
+        PyObject* arraymod = PyImport_ImportModule("array");
+        if (!arraymod) { throw std::runtime_error("Error loading module array!"); }
+        s_python_array_type = PyObject_GetAttrString(arraymod, "array");
+        Py_DECREF(arraymod);
+        if (!s_python_array_type) { throw std::runtime_error("Couldn't find array.array!"); }
+#endif
     }
 
     ~_interpreter() {
@@ -364,11 +381,74 @@ PyObject* get_2darray(const std::vector<::std::vector<Numeric>>& v)
     return reinterpret_cast<PyObject *>(varray);
 }
 
-#else // fallback if we don't have numpy: copy every element of the given vector
+#elif PY_MAJOR_VERSION >= 3 // fallback if we don't have numpy: copy the data into an array.array
+
+namespace detail {
+
+// Type selector for array.array typecodes, other types are converted to double
+template <typename T> struct select_array_type { static const bool value = false; static const char* code() { return "d"; } };
+template <> struct select_array_type<double> { static const bool value = true; static const char* code() { return "d"; } };
+template <> struct select_array_type<float> { static const bool value = true; static const char* code() { return "f"; } };
+template <> struct select_array_type<int8_t> { static const bool value = true; static const char* code() { return "b"; } };
+template <> struct select_array_type<int16_t> { static const bool value = true; static const char* code() { return "h"; } };
+template <> struct select_array_type<int32_t> { static const bool value = true; static const char* code() { return "i"; } };
+template <> struct select_array_type<int64_t> { static const bool value = true; static const char* code() { return "q"; } };
+template <> struct select_array_type<uint8_t> { static const bool value = true; static const char* code() { return "B"; } };
+template <> struct select_array_type<uint16_t> { static const bool value = true; static const char* code() { return "H"; } };
+template <> struct select_array_type<uint32_t> { static const bool value = true; static const char* code() { return "I"; } };
+template <> struct select_array_type<uint64_t> { static const bool value = true; static const char* code() { return "Q"; } };
+
+// Creates an array.array of the given typecode from contiguous data with a single memcpy
+// (array.frombytes reading a memoryview of the data). matplotlib converts it to a numpy
+// array through the buffer protocol, again without touching single elements.
+inline PyObject* get_buffer_array(const char* typecode, const void* data, size_t bytes)
+{
+    PyObject* array = PyObject_CallFunction(_interpreter::get().s_python_array_type, const_cast<char*>("s"), typecode);
+    if (!array) throw std::runtime_error("Call to array.array() failed.");
+
+    PyObject* memory = PyMemoryView_FromMemory(static_cast<char*>(const_cast<void*>(data)), bytes, PyBUF_READ);
+    if (!memory) {
+        Py_DECREF(array);
+        throw std::runtime_error("Call to PyMemoryView_FromMemory() failed.");
+    }
+    PyObject* res = PyObject_CallMethod(array, const_cast<char*>("frombytes"), const_cast<char*>("O"), memory);
+    Py_DECREF(memory);
+    if (!res) {
+        Py_DECREF(array);
+        throw std::runtime_error("Call to array.frombytes() failed.");
+    }
+    Py_DECREF(res);
+
+    return array;
+}
+
+template<typename Numeric>
+PyObject* get_vector_array(const std::vector<Numeric>& v, std::true_type)
+{
+    return get_buffer_array(select_array_type<Numeric>::code(), v.data(), v.size() * sizeof(Numeric));
+}
+
+template<typename Numeric>
+PyObject* get_vector_array(const std::vector<Numeric>& v, std::false_type)
+{
+    std::vector<double> vd(v.begin(), v.end());
+    return get_buffer_array("d", vd.data(), vd.size() * sizeof(double));
+}
+
+} // end namespace detail
+
+template<typename Numeric>
+PyObject* get_array(const std::vector<Numeric>& v)
+{
+    return detail::get_vector_array(v, std::integral_constant<bool, detail::select_array_type<Numeric>::value>());
+}
+
+#else // fallback if we don't have numpy (python 2): copy every element of the given vector
 
 template<typename Numeric>
 PyObject* get_array(const std::vector<Numeric>& v)
 {
+    detail::_interpreter::get();    //interpreter needs to be initialized before the list is created
     PyObject* list = PyList_New(v.size());
     for(size_t i = 0; i < v.size(); ++i) {
         PyList_SetItem(list, i, PyFloat_FromDouble(v.at(i)));
@@ -378,6 +458,110 @@ PyObject* get_array(const std::vector<Numeric>& v)
 
 #endif // WITHOUT_NUMPY
 
+#ifdef EIGEN_WORLD_VERSION
+
+namespace detail {
+
+template<typename T>
+struct is_eigen : std::is_base_of<Eigen::EigenBase<T>, T> {};
+
+#ifndef WITHOUT_NUMPY
+
+// Vectors with direct storage access (Matrix, Map, Ref, blocks): the numpy array views the
+// Eigen storage with its stride, nothing is copied. As for std::vector, the data has to stay
+// alive until matplotlib is done with it.
+template<typename Derived>
+PyObject* get_eigen_array(const Eigen::DenseBase<Derived>& v, std::true_type)
+{
+    typedef typename Derived::Scalar Scalar;
+    npy_intp vsize = v.size();
+    npy_intp vstride = v.innerStride() * sizeof(Scalar);
+    return PyArray_New(&PyArray_Type, 1, &vsize, select_npy_type<Scalar>::type, &vstride,
+                       const_cast<Scalar*>(v.derived().data()), 0, NPY_ARRAY_ALIGNED, NULL);
+}
+
+// Expressions (and scalar types numpy does not know): evaluated once, directly into a numpy owned buffer
+template<typename Derived>
+PyObject* get_eigen_array(const Eigen::DenseBase<Derived>& v, std::false_type)
+{
+    typedef typename Derived::Scalar Scalar;
+    typedef typename std::conditional<select_npy_type<Scalar>::type == NPY_NOTYPE, double, Scalar>::type Target;
+    const NPY_TYPES type = (select_npy_type<Scalar>::type == NPY_NOTYPE) ? NPY_DOUBLE : select_npy_type<Scalar>::type;
+
+    npy_intp vsize = v.size();
+    PyObject* varray = PyArray_SimpleNew(1, &vsize, type);
+    Eigen::Map<Eigen::Matrix<Target, Derived::RowsAtCompileTime, Derived::ColsAtCompileTime> >(
+        static_cast<Target*>(PyArray_DATA(reinterpret_cast<PyArrayObject*>(varray))), v.rows(), v.cols()) = v.derived().template cast<Target>();
+    return varray;
+}
+
+template<typename Derived>
+struct has_direct_access : std::integral_constant<bool,
+    (Eigen::internal::traits<Derived>::Flags & Eigen::DirectAccessBit) != 0
+    && select_npy_type<typename Derived::Scalar>::type != NPY_NOTYPE> {};
+
+#elif PY_MAJOR_VERSION >= 3
+
+// Strided vectors and expressions are evaluated once into a contiguous buffer
+template<typename Derived>
+PyObject* get_eigen_array(const Eigen::DenseBase<Derived>& v, std::false_type)
+{
+    typedef typename Derived::Scalar Scalar;
+    typedef typename std::conditional<select_array_type<Scalar>::value, Scalar, double>::type Target;
+
+    Eigen::Matrix<Target, Eigen::Dynamic, 1> plain(v.size());
+    Eigen::Map<Eigen::Matrix<Target, Derived::RowsAtCompileTime, Derived::ColsAtCompileTime> >(
+        plain.data(), v.rows(), v.cols()) = v.derived().template cast<Target>();
+    return get_buffer_array(select_array_type<Target>::code(), plain.data(), plain.size() * sizeof(Target));
+}
+
+// Contiguous vectors are copied into the array.array with a single memcpy
+template<typename Derived>
+PyObject* get_eigen_array(const Eigen::DenseBase<Derived>& v, std::true_type)
+{
+    typedef typename Derived::Scalar Scalar;
+    if (v.innerStride() != 1) return get_eigen_array(v, std::false_type());
+    return get_buffer_array(select_array_type<Scalar>::code(), v.derived().data(), v.size() * sizeof(Scalar));
+}
+
+template<typename Derived>
+struct has_direct_access : std::integral_constant<bool,
+    (Eigen::internal::traits<Derived>::Flags & Eigen::DirectAccessBit) != 0
+    && select_array_type<typename Derived::Scalar>::value> {};
+
+#endif // WITHOUT_NUMPY
+
+} // end namespace detail
+
+#if !defined(WITHOUT_NUMPY) || PY_MAJOR_VERSION >= 3
+
+template<typename Derived>
+PyObject* get_array(const Eigen::DenseBase<Derived>& v)
+{
+    detail::_interpreter::get();    //interpreter needs to be initialized for the numpy commands to work
+    assert(v.rows() == 1 || v.cols() == 1);
+    return detail::get_eigen_array(v, typename detail::has_direct_access<Derived>::type());
+}
+
+#else // fallback if we don't have numpy (python 2): copy every element of the given vector
+
+template<typename Derived>
+PyObject* get_array(const Eigen::DenseBase<Derived>& v)
+{
+    detail::_interpreter::get();    //interpreter needs to be initialized before the list is created
+    assert(v.rows() == 1 || v.cols() == 1);
+    typename Derived::PlainObject plain = v.derived();
+    PyObject* list = PyList_New(plain.size());
+    for(Eigen::Index i = 0; i < plain.size(); ++i) {
+        PyList_SetItem(list, i, PyFloat_FromDouble(plain(i)));
+    }
+    return list;
+}
+
+#endif // WITHOUT_NUMPY
+
+#endif // EIGEN_WORLD_VERSION
+
 template<typename Numeric>
 bool plot(const std::vector<Numeric> &x, const std::vector<Numeric> &y, const std::map<std::string, std::string>& keywords)
 {
@@ -1577,6 +1761,219 @@ inline void tight_layout() {
     Py_DECREF(res);
 }
 
+#ifdef EIGEN_WORLD_VERSION
+
+/*
+ * Overloads for Eigen vectors, maps, refs and expressions. Data with direct storage access
+ * is handed to numpy without copying (see get_array), float data is passed as float.
+ * The arrays are created first, which also initializes the interpreter.
+ */
+
+template<typename DerivedX, typename DerivedY>
+typename std::enable_if<detail::is_eigen<DerivedX>::value && detail::is_eigen<DerivedY>::value, bool>::type
+plot(const DerivedX& x, const DerivedY& y, const std::string& format = "")
+{
+    assert(x.size() == y.size());
+
+    PyObject* xarray = get_array(x);
+    PyObject* yarray = get_array(y);
+
+    PyObject* pystring = PyString_FromString(format.c_str());
+
+    PyObject* plot_args = PyTuple_New(3);
+    PyTuple_SetItem(plot_args, 0, xarray);
+    PyTuple_SetItem(plot_args, 1, yarray);
+    PyTuple_SetItem(plot_args, 2, pystring);
+
+    PyObject* res = PyObject_CallObject(detail::_interpreter::get().s_python_function_plot, plot_args);
+
+    Py_DECREF(plot_args);
+    if(res) Py_DECREF(res);
+
+    return res;
+}
+
+template<typename DerivedX, typename DerivedY>
+typename std::enable_if<detail::is_eigen<DerivedX>::value && detail::is_eigen<DerivedY>::value, bool>::type
+plot(const DerivedX& x, const DerivedY& y, const std::map<std::string, std::string>& keywords)
+{
+    assert(x.size() == y.size());
+
+    PyObject* xarray = get_array(x);
+    PyObject* yarray = get_array(y);
+
+    PyObject* args = PyTuple_New(2);
+    PyTuple_SetItem(args, 0, xarray);
+    PyTuple_SetItem(args, 1, yarray);
+
+    PyObject* kwargs = PyDict_New();
+    for(std::map<std::string, std::string>::const_iterator it = keywords.begin(); it != keywords.end(); ++it)
+    {
+        PyDict_SetItemString(kwargs, it->first.c_str(), PyString_FromString(it->second.c_str()));
+    }
+
+    PyObject* res = PyObject_Call(detail::_interpreter::get().s_python_function_plot, args, kwargs);
+
+    Py_DECREF(args);
+    Py_DECREF(kwargs);
+    if(res) Py_DECREF(res);
+
+    return res;
+}
+
+template<typename DerivedY>
+typename std::enable_if<detail::is_eigen<DerivedY>::value, bool>::type
+plot(const DerivedY& y, const std::string& format = "")
+{
+    PyObject* yarray = get_array(y);
+
+    PyObject* pystring = PyString_FromString(format.c_str());
+
+    PyObject* plot_args = PyTuple_New(2);
+    PyTuple_SetItem(plot_args, 0, yarray);
+    PyTuple_SetItem(plot_args, 1, pystring);
+
+    PyObject* res = PyObject_CallObject(detail::_interpreter::get().s_python_function_plot, plot_args);
+
+    Py_DECREF(plot_args);
+    if(res) Py_DECREF(res);
+
+    return res;
+}
+
+template<typename DerivedY>
+typename std::enable_if<detail::is_eigen<DerivedY>::value, bool>::type
+named_plot(const std::string& name, const DerivedY& y, const std::string& format = "")
+{
+    PyObject* yarray = get_array(y);
+
+    PyObject* kwargs = PyDict_New();
+    PyDict_SetItemString(kwargs, "label", PyString_FromString(name.c_str()));
+
+    PyObject* pystring = PyString_FromString(format.c_str());
+
+    PyObject* plot_args = PyTuple_New(2);
+    PyTuple_SetItem(plot_args, 0, yarray);
+    PyTuple_SetItem(plot_args, 1, pystring);
+
+    PyObject* res = PyObject_Call(detail::_interpreter::get().s_python_function_plot, plot_args, kwargs);
+
+    Py_DECREF(kwargs);
+    Py_DECREF(plot_args);
+    if (res) Py_DECREF(res);
+
+    return res;
+}
+
+template<typename DerivedX, typename DerivedY>
+typename std::enable_if<detail::is_eigen<DerivedX>::value && detail::is_eigen<DerivedY>::value, bool>::type
+named_plot(const std::string& name, const DerivedX& x, const DerivedY& y, const std::string& format = "")
+{
+    assert(x.size() == y.size());
+
+    PyObject* xarray = get_array(x);
+    PyObject* yarray = get_array(y);
+
+    PyObject* kwargs = PyDict_New();
+    PyDict_SetItemString(kwargs, "label", PyString_FromString(name.c_str()));
+
+    PyObject* pystring = PyString_FromString(format.c_str());
+
+    PyObject* plot_args = PyTuple_New(3);
+    PyTuple_SetItem(plot_args, 0, xarray);
+    PyTuple_SetItem(plot_args, 1, yarray);
+    PyTuple_SetItem(plot_args, 2, pystring);
+
+    PyObject* res = PyObject_Call(detail::_interpreter::get().s_python_function_plot, plot_args, kwargs);
+
+    Py_DECREF(kwargs);
+    Py_DECREF(plot_args);
+    if (res) Py_DECREF(res);
+
+    return res;
+}
+
+template<typename DerivedX, typename DerivedY>
+typename std::enable_if<detail::is_eigen<DerivedX>::value && detail::is_eigen<DerivedY>::value, bool>::type
+stem(const DerivedX& x, const DerivedY& y, const std::string& format = "")
+{
+    assert(x.size() == y.size());
+
+    PyObject* xarray = get_array(x);
+    PyObject* yarray = get_array(y);
+
+    PyObject* pystring = PyString_FromString(format.c_str());
+
+    PyObject* plot_args = PyTuple_New(3);
+    PyTuple_SetItem(plot_args, 0, xarray);
+    PyTuple_SetItem(plot_args, 1, yarray);
+    PyTuple_SetItem(plot_args, 2, pystring);
+
+    PyObject* res = PyObject_CallObject(detail::_interpreter::get().s_python_function_stem, plot_args);
+
+    Py_DECREF(plot_args);
+    if (res) Py_DECREF(res);
+
+    return res;
+}
+
+template<typename DerivedX, typename DerivedY>
+typename std::enable_if<detail::is_eigen<DerivedX>::value && detail::is_eigen<DerivedY>::value, bool>::type
+scatter(const DerivedX& x, const DerivedY& y, const double s=1.0) // The marker size in points**2
+{
+    assert(x.size() == y.size());
+
+    PyObject* xarray = get_array(x);
+    PyObject* yarray = get_array(y);
+
+    PyObject* kwargs = PyDict_New();
+    PyDict_SetItemString(kwargs, "s", PyFloat_FromDouble(s));
+
+    PyObject* plot_args = PyTuple_New(2);
+    PyTuple_SetItem(plot_args, 0, xarray);
+    PyTuple_SetItem(plot_args, 1, yarray);
+
+    PyObject* res = PyObject_Call(detail::_interpreter::get().s_python_function_scatter, plot_args, kwargs);
+
+    Py_DECREF(plot_args);
+    Py_DECREF(kwargs);
+    if(res) Py_DECREF(res);
+
+    return res;
+}
+
+template<typename DerivedX, typename DerivedY1, typename DerivedY2>
+typename std::enable_if<detail::is_eigen<DerivedX>::value && detail::is_eigen<DerivedY1>::value && detail::is_eigen<DerivedY2>::value, bool>::type
+fill_between(const DerivedX& x, const DerivedY1& y1, const DerivedY2& y2, const std::map<std::string, std::string>& keywords)
+{
+    assert(x.size() == y1.size());
+    assert(x.size() == y2.size());
+
+    PyObject* xarray = get_array(x);
+    PyObject* y1array = get_array(y1);
+    PyObject* y2array = get_array(y2);
+
+    PyObject* args = PyTuple_New(3);
+    PyTuple_SetItem(args, 0, xarray);
+    PyTuple_SetItem(args, 1, y1array);
+    PyTuple_SetItem(args, 2, y2array);
+
+    PyObject* kwargs = PyDict_New();
+    for(std::map<std::string, std::string>::const_iterator it = keywords.begin(); it != keywords.end(); ++it) {
+        PyDict_SetItemString(kwargs, it->first.c_str(), PyUnicode_FromString(it->second.c_str()));
+    }
+
+    PyObject* res = PyObject_Call(detail::_interpreter::get().s_python_function_fill_between, args, kwargs);
+
+    Py_DECREF(args);
+    Py_DECREF(kwargs);
+    if(res) Py_DECREF(res);
+
+    return res;
+}
+
+#endif // EIGEN_WORLD_VERSION
+
 // Support for variadic plot() and initializer lists:
 
 namespace detail {
@@ -1719,6 +2116,8 @@ public:
 
         assert(x.size() == y.size());
 
+        detail::_interpreter::get(); // the interpreter has to exist before the first Python object is created
+
         PyObject* kwargs = PyDict_New();
         if(name != "")
             PyDict_SetItemString(kwargs, "label", PyString_FromString(name.c_str()));
@@ -1743,9 +2142,10 @@ public:
             line= PyList_GetItem(res, 0);
 
             if(line)
+            {
+                Py_INCREF(line); // PyList_GetItem returns a borrowed reference
                 set_data_fct = PyObject_GetAttrString(line,"set_data");
-            else
-                Py_DECREF(line);
+            }
             Py_DECREF(res);
         }
     }
@@ -1768,12 +2168,54 @@ public:
             PyTuple_SetItem(plot_args, 1, yarray);
 
             PyObject* res = PyObject_CallObject(set_data_fct, plot_args);
+            Py_DECREF(plot_args);
             if (res) Py_DECREF(res);
+            changed = true;
             return res;
         }
         return false;
     }
 
+#ifdef EIGEN_WORLD_VERSION
+    // updates the line with Eigen data, without copying it (see get_array): the data has
+    // to stay alive as long as the line shows it
+    template<typename DerivedX, typename DerivedY>
+    typename std::enable_if<detail::is_eigen<DerivedX>::value && detail::is_eigen<DerivedY>::value, bool>::type
+    update(const DerivedX& x, const DerivedY& y) {
+        assert(x.size() == y.size());
+        if(set_data_fct)
+        {
+            PyObject* xarray = get_array(x);
+            PyObject* yarray = get_array(y);
+
+            PyObject* plot_args = PyTuple_New(2);
+            PyTuple_SetItem(plot_args, 0, xarray);
+            PyTuple_SetItem(plot_args, 1, yarray);
+
+            PyObject* res = PyObject_CallObject(set_data_fct, plot_args);
+            Py_DECREF(plot_args);
+            if (res) Py_DECREF(res);
+            changed = true;
+            return res;
+        }
+        return false;
+    }
+#endif // EIGEN_WORLD_VERSION
+
+    // the matplotlib Line2D of this plot (borrowed)
+    PyObject* get_line() const {
+        return line;
+    }
+
+    // true if the data was updated since the last Animation::redraw
+    bool is_changed() const {
+        return changed;
+    }
+
+    void set_changed(bool flag) {
+        changed = flag;
+    }
+
     // clears the plot but keep it available
     bool clear() {
         return update(std::vector<double>(), std::vector<double>());
@@ -1786,6 +2228,8 @@ public:
             auto remove_fct = PyObject_GetAttrString(line,"remove");
             PyObject* args = PyTuple_New(0);
             PyObject* res = PyObject_CallObject(remove_fct, args);
+            Py_DECREF(args);
+            Py_DECREF(remove_fct);
             if (res) Py_DECREF(res);
         }
         decref();
@@ -1801,11 +2245,158 @@ private:
             Py_DECREF(line);
         if(set_data_fct)
             Py_DECREF(set_data_fct);
+        line = nullptr;
+        set_data_fct = nullptr;
     }
 
 
     PyObject* line = nullptr;
     PyObject* set_data_fct = nullptr;
+    bool changed = false;
+};
+
+/*
+ * This class redraws a set of Plot lines in place, for live plots: the lines are created once
+ * and updated with Plot::update (set_data), instead of clf() and plotting everything again.
+ * With blitting (if the backend supports it) the static part of the axes (axes, ticks, legend,
+ * text) is rendered once and cached, and redraw() only restores the cache and draws the lines.
+ * With autoscaling the limits follow the data, which needs a full redraw whenever a line changed.
+ *
+ * The animation keeps pointers to the added lines, it does not own them: every added Plot has
+ * to outlive the animation (or at least its last redraw()). The animation owns references to
+ * the axes, the canvas and the cached background, so it can not be copied.
+ */
+
+class Animation
+{
+public:
+    Animation(bool autoscale = false, bool blit = true)
+        : autoscale(autoscale), blit(blit) {}
+
+    Animation(const Animation&) = delete;
+    Animation& operator=(const Animation&) = delete;
+
+    ~Animation() {
+        Py_XDECREF(background);
+        Py_XDECREF(canvas);
+        Py_XDECREF(axes);
+    }
+
+    // adds a line, all lines have to be in the same axes (the line is not copied, see above)
+    bool add(Plot& plot) {
+        PyObject* line = plot.get_line();
+        if(!line) return false;
+
+        if(!axes)
+        {
+            axes = PyObject_GetAttrString(line, "axes");
+            PyObject* figure = PyObject_GetAttrString(line, "figure");
+            if(!axes || !figure) throw std::runtime_error("Line has no axes.");
+            canvas = PyObject_GetAttrString(figure, "canvas");
+            Py_DECREF(figure);
+            if(!canvas) throw std::runtime_error("Figure has no canvas.");
+
+            blit = blit && PyObject_HasAttrString(canvas, "copy_from_bbox") && PyObject_HasAttrString(canvas, "restore_region");
+        }
+
+        if(blit)
+        {
+            // animated artists are left out of the normal draw, i.e. out of the cached background
+            PyObject* res = PyObject_CallMethod(line, const_cast<char*>("set_animated"), const_cast<char*>("O"), Py_True);
+            if(!res) return false;
+            Py_DECREF(res);
+        }
+
+        plots.push_back(&plot);
+        plot.set_changed(true);
+        invalidate();
+        return true;
+    }
+
+    void set_autoscale(bool flag) {
+        autoscale = flag;
+        invalidate();
+    }
+
+    bool is_blitting() const {
+        return blit;
+    }
+
+    // forces a full redraw at the next redraw(), e.g. after changing the title, the limits or the window size
+    void invalidate() {
+        Py_XDECREF(background);
+        background = nullptr;
+    }
+
+    // redraws the changed lines, returns false if nothing had to be drawn or the drawing failed
+    bool redraw() {
+        bool anyChanged = false;
+        for(size_t i = 0; i < plots.size(); ++i)
+            anyChanged = anyChanged || plots[i]->is_changed();
+        if(!axes || (!anyChanged && (background || !blit))) return false;
+
+        if(autoscale && anyChanged)
+        {
+            if(!call(axes, "relim") || !call(axes, "autoscale_view")) return false;
+            invalidate();
+        }
+
+        if(!blit)
+        {
+            if(!call(canvas, "draw_idle")) return false;
+        }
+        else
+        {
+            if(!background)
+            {
+                // full draw without the animated lines, then cache the axes area
+                if(!call(canvas, "draw")) return false;
+                PyObject* bbox = PyObject_GetAttrString(axes, "bbox");
+                background = PyObject_CallMethod(canvas, const_cast<char*>("copy_from_bbox"), const_cast<char*>("O"), bbox);
+                Py_DECREF(bbox);
+                if(!background) return false;
+            }
+            else
+            {
+                PyObject* res = PyObject_CallMethod(canvas, const_cast<char*>("restore_region"), const_cast<char*>("O"), background);
+                if(!res) return false;
+                Py_DECREF(res);
+            }
+
+            for(size_t i = 0; i < plots.size(); ++i)
+            {
+                PyObject* res = PyObject_CallMethod(axes, const_cast<char*>("draw_artist"), const_cast<char*>("O"), plots[i]->get_line());
+                if(!res) return false;
+                Py_DECREF(res);
+            }
+
+            PyObject* bbox = PyObject_GetAttrString(axes, "bbox");
+            PyObject* res = PyObject_CallMethod(canvas, const_cast<char*>("blit"), const_cast<char*>("O"), bbox);
+            Py_DECREF(bbox);
+            if(!res) return false;
+            Py_DECREF(res);
+        }
+
+        if(!call(canvas, "flush_events")) return false;
+
+        for(size_t i = 0; i < plots.size(); ++i)
+            plots[i]->set_changed(false);
+        return true;
+    }
+
+private:
+    static bool call(PyObject* object, const char* method) {
+        PyObject* res = PyObject_CallMethod(object, const_cast<char*>(method), NULL);
+        if(res) Py_DECREF(res);
+        return res;
+    }
+
+    std::vector<Plot*> plots;
+    PyObject* axes = nullptr;
+    PyObject* canvas = nullptr;
+    PyObject* background = nullptr;
+    bool autoscale;
+    bool blit;
 };
 
 } // end namespace matplotlibcpp
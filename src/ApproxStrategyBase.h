@@ -27,14 +27,156 @@ namespace APPRSDK
             ERowVec<T> _ub;
 
             bool _isJacobiInfoAvailable;
+
+            OptimizationBudget<T> _budget;
+            StopReason _stopReason;
+
+            OptimizerState<T> _resumeState;
+            bool _reuseResumeValues;
+
+            /*! \brief takeResumeState
+            *
+            * Returns the state set by SetState if it was exported by the given strategy and
+            * has n parameters (n = 0 accepts any dimension). The state is used by one
+            * optimization only, so it is cleared.
+            */
+            bool takeResumeState(const std::string& strategy, unsigned int n, OptimizerState<T>& state)
+            {
+                bool ret = !_resumeState.IsEmpty() && _resumeState.strategy == strategy &&
+                           (n == 0 || _resumeState.points.cols() == (int)n);
+                if (ret)
+                {
+                    state = _resumeState;
+                }
+                _resumeState = OptimizerState<T>();
+                return ret;
+            }
+
+            /*! \brief isReusable
+            *
+            * True if a stored value may be used instead of evaluating the objective again.
+            * Values recorded after the budget ran out are never reused.
+            */
+            bool isReusable(T value)
+            {
+                return _reuseResumeValues && value < std::numeric_limits<T>::max();
+            }
+
+            /*! \brief evaluate
+            *
+            * Evaluates the objective at the given position and records it in the budget.
+            * Once the budget is exhausted the objective is not called anymore, and the
+            * largest representable value is returned, so the point is never accepted.
+            */
+            T evaluate(ERowVec<T> position)
+            {
+                if (_budget.IsExhausted())
+                {
+                    return std::numeric_limits<T>::max();
+                }
+
+                T ret = (*_minObjPtr)(position);
+                _budget.Record(position, ret);
+                return ret;
+            }
+
+            /*! \brief hasBoundaries
+            *
+            * Returns true if bound constraints matching the dimension n were set.
+            */
+            bool hasBoundaries(unsigned int n)
+            {
+                return (_lb.size() == _ub.size()) && (_lb.size() == (int)n);
+            }
+
+            /*! \brief projectToBoundaries
+            *
+            * Clamps each coordinate of x into [_lb, _ub] if boundaries were set.
+            * Works with any indexable vector (ERowVec, Coord).
+            */
+            template<typename Vec>
+            void projectToBoundaries(Vec& x)
+            {
+                if (!hasBoundaries(x.size()))
+                {
+                    return;
+                }
+
+                for (unsigned int i = 0; i < (unsigned int)x.size(); ++i)
+                {
+                    if (x[i] < _lb[i])
+                    {
+                        x[i] = _lb[i];
+                    }
+                    else if (x[i] > _ub[i])
+                    {
+                        x[i] = _ub[i];
+                    }
+                }
+            }
+
+            /*! \brief finish
+            *
+            * Sets the stop reason at the end of an optimization. If the budget ran out, its
+            * reason is reported and the best point found so far is returned as the position.
+            */
+            void finish(StopReason reason)
+            {
+                _budget.Finish();
+
+                if (_budget.GetExhaustedReason() != NotStopped)
+                {
+                    _stopReason = _budget.GetExhaustedReason();
+                }
+                else
+                {
+                    _stopReason = reason;
+                }
+
+                if (_budget.HasBest() && _budget.GetBestError() < _currentError)
+                {
+                    _currentPosition = _budget.GetBestPosition();
+                    _currentError = _budget.GetBestError();
+                }
+            }
         
         public:
 
-            ApproxStrategyBase() :_isJacobiInfoAvailable(false)
+            ApproxStrategyBase() :_currentIteration(0), _isJacobiInfoAvailable(false), _stopReason(NotStopped), _reuseResumeValues(false)
             {
 
             }
 
+            /*! \brief GetState
+            *
+            * Returns the state of the last optimization. The base version exports the
+            * position and its error, strategies with more internal state extend it.
+            */
+            OptimizerState<T> GetState()
+            {
+                OptimizerState<T> ret;
+                ret.iterations = _currentIteration;
+                if (_currentPosition.size() > 0)
+                {
+                    ret.points = _currentPosition;
+                    ret.values = EColVec<T>::Constant(1, _currentError);
+                }
+                return ret;
+            }
+
+            /*! \brief SetState
+            *
+            * The next optimization starts from the given state instead of the input parameters.
+            * If reuseValues is true the stored errors (and linearizations) are trusted, which is
+            * only valid if the objective did not change (i.e. an interrupted fit is continued);
+            * otherwise the stored points are evaluated again (i.e. a warm start on the next signal).
+            */
+            void SetState(const OptimizerState<T>& state, bool reuseValues)
+            {
+                _resumeState = state;
+                _reuseResumeValues = reuseValues;
+            }
+
             int GetIterations()
             {
                 return _currentIteration;
@@ -68,7 +210,32 @@ namespace APPRSDK
 
             T GetObjectVal()
             {
-                return (*_minObjPtr)(_currentPosition);
+                return evaluate(_currentPosition);
+            }
+
+            void SetBudget(OptimizationBudget<T> budget)
+            {
+                _budget = budget;
+            }
+
+            bool IsBudgetExhausted()
+            {
+                return _budget.IsExhausted();
+            }
+
+            StopReason GetStopReason()
+            {
+                return _stopReason;
+            }
+
+            double GetElapsedTime()
+            {
+                return _budget.GetElapsedTime();
+            }
+
+            unsigned int GetNumberOfEvaluations()
+            {
+                return _budget.GetNumberOfEvaluations();
             }
 
             EMatrix<T> GetJacobian()
@@ -0,0 +1,220 @@
+#ifndef __ASYNCPLOTTER_H_INCLUDED__
+#define __ASYNCPLOTTER_H_INCLUDED__
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include "TypeDefs.h"
+#include "SnapshotQueue.h"
+#include "matplotlibcpp.h"
+
+namespace APPRSDK
+{
+    /*! \brief PlotSnapshot
+    *
+    * One frame of the live plot: the signal, the approximation and the parameters
+    * of an evaluation.
+    */
+    template<typename T>
+    struct PlotSnapshot
+    {
+        ERowVec<T> signal;
+        ERowVec<T> approximation;
+        ERowVec<T> parameters;
+        T error;
+    };
+
+    /*! \brief AsyncPlotter
+    *
+    * Draws the approximation on a consumer thread, so the optimizer never waits for Python.
+    * The objective publishes snapshots into a bounded lock-free SnapshotQueue: Publish copies
+    * into a preallocated slot and returns immediately, frames are dropped if the plot can not
+    * keep up, and the consumer only draws the newest frame. Only the consumer thread calls
+    * matplotlib (holding the GIL), so the optimizer thread never waits for the interpreter.
+    * Publish is a single atomic load when the plotter is not running.
+    *
+    * The GUI backends (TkAgg, Qt, macosx) only support drawing from the main thread, so
+    * the plotter is meant for non-interactive backends such as Agg (i.e. MPLBACKEND=Agg,
+    * saving frames). With a GUI backend the window may not update, or the program may crash.
+    */
+    template<typename T>
+    class AsyncPlotter
+    {
+        protected:
+            SnapshotQueue<PlotSnapshot<T> > _queue;
+            std::atomic<bool> _running;
+            std::thread _consumer;
+            double _pause;
+            std::atomic<unsigned long> _drawn;
+            PyThreadState* _savedThread;
+            ERowVec<T> _x;
+
+            /*! \brief createFigure
+            *
+            * Creates the signal and the approximation lines once (GIL held). Later frames
+            * only update their data and redraw the lines (see matplotlibcpp::Animation).
+            */
+            void createFigure(const PlotSnapshot<T>& frame, matplotlibcpp::Plot*& signalLine, matplotlibcpp::Plot*& approximationLine, matplotlibcpp::Animation*& animation)
+            {
+                delete animation;
+                delete signalLine;
+                delete approximationLine;
+
+                matplotlibcpp::clf();
+                _x = ERowVec<T>::LinSpaced(frame.signal.cols(), 0, frame.signal.cols() - 1);
+                signalLine = new matplotlibcpp::Plot("signal");
+                approximationLine = new matplotlibcpp::Plot("approximation", "r-");
+                signalLine->update(_x, frame.signal);
+                approximationLine->update(_x, frame.approximation);
+                matplotlibcpp::legend();
+                matplotlibcpp::title("APPRSDK Demo");
+                matplotlibcpp::pause(_pause);
+
+                // The limits are fitted to the first frame only, so later frames can be blitted
+                animation = new matplotlibcpp::Animation(true);
+                animation->add(*signalLine);
+                animation->add(*approximationLine);
+                animation->redraw();
+                animation->set_autoscale(false);
+            }
+
+            void consume()
+            {
+                // The lines view the storage of displayed (no copy): a frame is only given back
+                // to the queue after the lines were updated with the next one
+                PlotSnapshot<T> incoming, displayed;
+                matplotlibcpp::Plot* signalLine = 0;
+                matplotlibcpp::Plot* approximationLine = 0;
+                matplotlibcpp::Animation* animation = 0;
+
+                while (_running.load(std::memory_order_acquire))
+                {
+                    if (!_queue.TryPopLatest(incoming))
+                    {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                        continue;
+                    }
+
+                    PyGILState_STATE gil = PyGILState_Ensure();
+                    if (animation == 0 || incoming.signal.cols() != displayed.signal.cols())
+                    {
+                        createFigure(incoming, signalLine, approximationLine, animation);
+                    }
+                    else
+                    {
+                        signalLine->update(_x, incoming.signal);
+                        approximationLine->update(_x, incoming.approximation);
+                        animation->redraw();
+                    }
+                    PyGILState_Release(gil);
+
+                    std::swap(displayed, incoming);
+                    _drawn.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                PyGILState_STATE gil = PyGILState_Ensure();
+                delete animation;
+                delete signalLine;
+                delete approximationLine;
+                PyGILState_Release(gil);
+            }
+
+        public:
+            AsyncPlotter(unsigned int queueCapacity = 4) : _queue(queueCapacity), _running(false), _pause(0.1), _drawn(0), _savedThread(0)
+            {
+
+            }
+
+            ~AsyncPlotter()
+            {
+                Stop();
+            }
+
+            /*! \brief SetPause
+            *
+            * Sets the time (in seconds) the consumer gives to the GUI event loop after the
+            * figure was created.
+            */
+            void SetPause(double seconds)
+            {
+                _pause = seconds;
+            }
+
+            /*! \brief Start
+            *
+            * Starts the plot thread. The interpreter is initialized on the calling thread,
+            * which then releases the GIL to the plot thread until Stop is called, so the
+            * calling thread must not use matplotlib in the meantime.
+            */
+            void Start()
+            {
+                if (_running.load())
+                {
+                    return;
+                }
+
+                matplotlibcpp::detail::_interpreter::get();
+                _savedThread = PyEval_SaveThread();
+
+                _running.store(true, std::memory_order_release);
+                _consumer = std::thread(&AsyncPlotter<T>::consume, this);
+            }
+
+            void Stop()
+            {
+                _running.store(false, std::memory_order_release);
+                if (_consumer.joinable())
+                {
+                    _consumer.join();
+                }
+
+                if (_savedThread != 0)
+                {
+                    PyEval_RestoreThread(_savedThread);
+                    _savedThread = 0;
+                }
+            }
+
+            bool IsWatching() const
+            {
+                return _running.load(std::memory_order_relaxed);
+            }
+
+            /*! \brief Publish
+            *
+            * Producer side, called by the objective after an evaluation. Never blocks.
+            */
+            void Publish(const ERowVec<T>& signal, const ERowVec<T>& approximation, const ERowVecRef<T>& parameters, T error)
+            {
+                if (!IsWatching())
+                {
+                    return;
+                }
+
+                PlotSnapshot<T>* slot = _queue.BeginPush();
+                if (slot == 0)
+                {
+                    return;
+                }
+
+                slot->signal = signal;
+                slot->approximation = approximation;
+                slot->parameters = parameters;
+                slot->error = error;
+                _queue.EndPush();
+            }
+
+            unsigned long GetDroppedFrames() const
+            {
+                return _queue.GetDropped();
+            }
+
+            unsigned long GetDrawnFrames() const
+            {
+                return _drawn.load(std::memory_order_relaxed);
+            }
+    };
+}
+
+#endif
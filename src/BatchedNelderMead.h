@@ -0,0 +1,234 @@
+#ifndef __BATCHEDNELDERMEAD_H_INCLUDED__
+#define __BATCHEDNELDERMEAD_H_INCLUDED__
+
+#include <vector>
+#include "TypeDefs.h"
+
+namespace APPRSDK
+{
+    /*! \brief BatchedNelderMead
+    *
+    * Lock-step Nelder-Mead method for Lanes independent problems. Every lane runs the
+    * same control flow: the reflected point and the second trial point (expansion or
+    * contraction, depending on the lane) are evaluated for all lanes at once, the
+    * per-lane decisions are applied with masks (select), and shrink steps are only
+    * evaluated if at least one lane needs them. Lanes that reached the maximal error,
+    * the simplex size tolerance or the iteration limit are masked out and keep their state.
+    *
+    * The state is kept in structure-of-arrays layout, each vertex is a Lanes x p array.
+    * The objective has to provide the following method:
+    * void Evaluate(const LaneMatrix& parameters, LaneVec& errors)
+    * where row l of parameters is the parameter vector of lane l.
+    */
+    template<typename T, int Lanes, typename Objective>
+    class BatchedNelderMead
+    {
+        public:
+            typedef Eigen::Array<T, Lanes, 1> LaneVec;
+            typedef Eigen::Array<T, Lanes, Eigen::Dynamic> LaneMatrix;
+            typedef Eigen::Array<bool, Lanes, 1> LaneMask;
+            typedef Eigen::Array<int, Lanes, 1> LaneIndex;
+
+        protected:
+            std::vector<LaneMatrix> _vertices;
+            std::vector<LaneVec> _values;
+            LaneIndex _iterations;
+            LaneMask _active;
+            T _simplexTolerance;
+            unsigned long _evaluations;
+
+            /*! \brief compareSwap
+            *
+            * Swaps vertices a and b in the lanes where b has a smaller value than a.
+            */
+            void compareSwap(unsigned int a, unsigned int b)
+            {
+                LaneMask swap = _values[b] < _values[a];
+                const int p = _vertices[a].cols();
+
+                LaneMatrix va = _vertices[a];
+                _vertices[a] = swap.replicate(1, p).select(_vertices[b], _vertices[a]);
+                _vertices[b] = swap.replicate(1, p).select(va, _vertices[b]);
+
+                LaneVec fa = _values[a];
+                _values[a] = swap.select(_values[b], _values[a]);
+                _values[b] = swap.select(fa, _values[b]);
+            }
+
+            /*! \brief sortVertices
+            *
+            * Orders the vertices in every lane by their values (odd-even transposition sort),
+            * so that vertex 0 is the best and the last vertex is the worst one.
+            */
+            void sortVertices()
+            {
+                const unsigned int v = _vertices.size();
+                for (unsigned int pass = 0; pass < v; ++pass)
+                {
+                    for (unsigned int i = pass % 2; i + 1 < v; i += 2)
+                    {
+                        compareSwap(i, i + 1);
+                    }
+                }
+            }
+
+            void evaluate(Objective& objective, const LaneMatrix& parameters, LaneVec& errors)
+            {
+                objective.Evaluate(parameters, errors);
+                _evaluations++;
+            }
+
+        public:
+            BatchedNelderMead() : _simplexTolerance((T)1e-8), _evaluations(0)
+            {
+
+            }
+
+            /*! \brief SetSimplexTolerance
+            *
+            * A lane stops when the largest coordinate distance between its best and
+            * any other vertex falls below the given value.
+            */
+            void SetSimplexTolerance(T tolerance)
+            {
+                _simplexTolerance = tolerance;
+            }
+
+            /*! \brief Optimize
+            *
+            * vertices contains the p+1 starting vertices of every lane, active masks the lanes
+            * that hold a problem (i.e. the last batch of a set may be partially filled).
+            */
+            void Optimize(T maxError, unsigned int maxIterations, const std::vector<LaneMatrix>& vertices, Objective& objective, const LaneMask& active)
+            {
+                const unsigned int v = vertices.size();
+                const int p = vertices[0].cols();
+
+                _vertices = vertices;
+                _values.resize(v);
+                _iterations = LaneIndex::Zero();
+                _active = active;
+                _evaluations = 0;
+
+                for (unsigned int i = 0; i < v; ++i)
+                {
+                    evaluate(objective, _vertices[i], _values[i]);
+                }
+
+                LaneMatrix centroid(Lanes, p);
+                LaneMatrix reflected(Lanes, p);
+                LaneMatrix trial(Lanes, p);
+                LaneVec fr;
+                LaneVec ft;
+
+                for (unsigned int it = 0; it < maxIterations; ++it)
+                {
+                    sortVertices();
+
+                    // Masking out the converged lanes
+                    LaneVec size = LaneVec::Zero();
+                    for (unsigned int i = 1; i < v; ++i)
+                    {
+                        size = size.max((_vertices[i] - _vertices[0]).abs().rowwise().maxCoeff());
+                    }
+                    _active = _active && (_values[0] > maxError) && (size > _simplexTolerance);
+
+                    if (!_active.any())
+                    {
+                        break;
+                    }
+
+                    _iterations += _active.template cast<int>();
+
+                    const LaneMatrix& worst = _vertices[v-1];
+                    const LaneVec& fWorst = _values[v-1];
+                    const LaneVec& fSecondWorst = _values[v-2];
+                    const LaneVec& fBest = _values[0];
+
+                    centroid = LaneMatrix::Zero(Lanes, p);
+                    for (unsigned int i = 0; i + 1 < v; ++i)
+                    {
+                        centroid += _vertices[i];
+                    }
+                    centroid /= (T)(v - 1);
+
+                    // Reflection
+                    reflected = centroid + (centroid - worst);
+                    evaluate(objective, reflected, fr);
+
+                    LaneMask expand = fr < fBest;
+                    LaneMask acceptReflected = (!expand) && (fr < fSecondWorst);
+                    LaneMask outside = (!expand) && (!acceptReflected) && (fr < fWorst);
+                    LaneMask inside = (!expand) && (!acceptReflected) && (fr >= fWorst);
+
+                    // Second trial point: expansion, outside or inside contraction
+                    trial = expand.replicate(1, p).select(centroid + (T)2.0 * (centroid - worst),
+                            outside.replicate(1, p).select(centroid + (T)0.5 * (reflected - centroid),
+                                                            centroid + (T)0.5 * (worst - centroid)));
+
+                    LaneMask needTrial = _active && (expand || outside || inside);
+                    ft = fr;
+                    if (needTrial.any())
+                    {
+                        evaluate(objective, trial, ft);
+                    }
+
+                    LaneMask takeTrial = (expand && (ft < fr)) || ((outside || inside) && (ft < fr.min(fWorst)));
+                    LaneMask takeReflected = (expand && !(ft < fr)) || acceptReflected;
+                    LaneMask shrink = _active && (outside || inside) && !takeTrial;
+
+                    takeTrial = takeTrial && _active;
+                    takeReflected = takeReflected && _active;
+
+                    LaneMatrix newWorst = takeTrial.replicate(1, p).select(trial, takeReflected.replicate(1, p).select(reflected, worst));
+                    LaneVec newWorstValue = takeTrial.select(ft, takeReflected.select(fr, fWorst));
+                    _vertices[v-1] = newWorst;
+                    _values[v-1] = newWorstValue;
+
+                    // Shrink towards the best vertex
+                    if (shrink.any())
+                    {
+                        for (unsigned int i = 1; i < v; ++i)
+                        {
+                            trial = _vertices[0] + (T)0.5 * (_vertices[i] - _vertices[0]);
+                            evaluate(objective, trial, ft);
+                            _vertices[i] = shrink.replicate(1, p).select(trial, _vertices[i]);
+                            _values[i] = shrink.select(ft, _values[i]);
+                        }
+                    }
+                }
+
+                sortVertices();
+            }
+
+            /*! \brief GetPosition
+            *
+            * Returns the best vertex of every lane (one lane per row).
+            */
+            LaneMatrix GetPosition()
+            {
+                return _vertices[0];
+            }
+
+            LaneVec GetCurrentError()
+            {
+                return _values[0];
+            }
+
+            LaneIndex GetIterations()
+            {
+                return _iterations;
+            }
+
+            /*! \brief GetNumberOfEvaluations
+            *
+            * Returns the number of batched objective evaluations (each covers all lanes).
+            */
+            unsigned long GetNumberOfEvaluations()
+            {
+                return _evaluations;
+            }
+    };
+}
+
+#endif
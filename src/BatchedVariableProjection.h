@@ -0,0 +1,292 @@
+#ifndef __BATCHEDVARIABLEPROJECTION_H_INCLUDED__
+#define __BATCHEDVARIABLEPROJECTION_H_INCLUDED__
+
+#include <vector>
+#include "OrthonormalHermiteBatch.h"
+#include "BatchedNelderMead.h"
+
+namespace APPRSDK
+{
+    /*! \brief BatchedVariableProjection class
+    *
+    * Variable projection with the orthonormal Hermite system for many small independent
+    * problems (one signal per problem, parameters: dilatation and translation). Lanes
+    * problems are evaluated together: the function systems are generated by
+    * OrthonormalHermiteBatch, and the linear least squares problems are solved through
+    * the normal equations with a Cholesky decomposition that runs on all lanes at once,
+    * so every step operates on fixed-size arrays of length Lanes. The nonlinear
+    * parameters are optimized by the lock-step BatchedNelderMead strategy.
+    *
+    * The error of a lane is the norm of the residual, as in VariableProjection (with
+    * unit weights).
+    */
+    template<typename T, int Lanes>
+    class BatchedVariableProjection
+    {
+        public:
+            typedef Eigen::Array<T, Lanes, 1> LaneVec;
+            typedef Eigen::Array<T, Lanes, Eigen::Dynamic> LaneMatrix;
+            typedef Eigen::Array<bool, Lanes, 1> LaneMask;
+
+        protected:
+            OrthonormalHermiteBatch<T, Lanes> _functionSystem;
+            unsigned int _numberOfValues;
+            unsigned int _degrees;
+
+            LaneMatrix _signals;
+            LaneMatrix _gram;
+            LaneMatrix _rhs;
+            LaneMatrix _linParams;
+
+            T _maximumErrorForOptimisation;
+            unsigned int _maximumNumberOfIterationsForOptimisation;
+            ERowVec<T> _initialStep;
+
+            unsigned long _batchedEvaluations;
+
+            /*! \brief solveNormalEquations
+            *
+            * Solves G c = b for every lane with the Cholesky decomposition G = L L^T.
+            * The decomposition is done in place in _gram (lower triangle).
+            */
+            void solveNormalEquations()
+            {
+                const unsigned int n = _degrees;
+
+                // Tiny regularization, the functions may vanish on the grid for extreme parameters
+                LaneVec ridge = LaneVec::Constant((T)1e-12);
+                for (unsigned int k = 0; k < n; ++k)
+                {
+                    ridge = ridge.max(_gram.col(k*n + k) * (T)1e-12);
+                }
+
+                for (unsigned int j = 0; j < n; ++j)
+                {
+                    LaneVec d = _gram.col(j*n + j) + ridge;
+                    for (unsigned int k = 0; k < j; ++k)
+                    {
+                        d -= _gram.col(j*n + k).square();
+                    }
+                    d = d.max(ridge).sqrt();
+                    _gram.col(j*n + j) = d;
+
+                    for (unsigned int i = j+1; i < n; ++i)
+                    {
+                        LaneVec s = _gram.col(i*n + j);
+                        for (unsigned int k = 0; k < j; ++k)
+                        {
+                            s -= _gram.col(i*n + k) * _gram.col(j*n + k);
+                        }
+                        _gram.col(i*n + j) = s / d;
+                    }
+                }
+
+                // Forward substitution L y = b
+                for (unsigned int i = 0; i < n; ++i)
+                {
+                    LaneVec s = _rhs.col(i);
+                    for (unsigned int k = 0; k < i; ++k)
+                    {
+                        s -= _gram.col(i*n + k) * _linParams.col(k);
+                    }
+                    _linParams.col(i) = s / _gram.col(i*n + i);
+                }
+
+                // Back substitution L^T c = y
+                for (int i = n-1; i >= 0; --i)
+                {
+                    LaneVec s = _linParams.col(i);
+                    for (unsigned int k = i+1; k < n; ++k)
+                    {
+                        s -= _gram.col(k*n + i) * _linParams.col(k);
+                    }
+                    _linParams.col(i) = s / _gram.col(i*n + i);
+                }
+            }
+
+        public:
+            BatchedVariableProjection(unsigned int numberOfValues, unsigned int degrees) :
+                _functionSystem(numberOfValues, degrees)
+            {
+                _numberOfValues = numberOfValues;
+                _degrees = degrees;
+                _signals = LaneMatrix::Zero(Lanes, numberOfValues);
+                _gram.resize(Lanes, degrees * degrees);
+                _rhs.resize(Lanes, degrees);
+                _linParams.resize(Lanes, degrees);
+                _maximumErrorForOptimisation = 0;
+                _maximumNumberOfIterationsForOptimisation = 100;
+                _initialStep.resize(2);
+                _initialStep(0) = (T)0.1;
+                _initialStep(1) = (T)1.5;
+                _batchedEvaluations = 0;
+            }
+
+            void SetMaxErrorForOptimisation(T maxErr)
+            {
+                _maximumErrorForOptimisation = maxErr;
+            }
+
+            void SetMaxIterationForOptimisation(unsigned int maxIteration)
+            {
+                _maximumNumberOfIterationsForOptimisation = maxIteration;
+            }
+
+            /*! \brief SetInitialStep
+            *
+            * Sets the offsets of the dilatation and the translation used to build the
+            * starting simplex around the initial parameters of each problem.
+            */
+            void SetInitialStep(ERowVec<T> step)
+            {
+                _initialStep = step;
+            }
+
+            /*! \brief SetSignals
+            *
+            * Sets the signals of the current batch, row l belongs to lane l.
+            */
+            void SetSignals(const LaneMatrix& signals)
+            {
+                _signals = signals;
+            }
+
+            /*! \brief Evaluate
+            *
+            * Computes the error of every lane for the given parameters
+            * (column 0: dilatation, column 1: translation).
+            */
+            void Evaluate(const LaneMatrix& parameters, LaneVec& errors)
+            {
+                const unsigned int n = _degrees;
+                _batchedEvaluations++;
+
+                _functionSystem.ApplyNonLinearParameters(parameters.col(0), parameters.col(1));
+
+                _gram.setZero();
+                _rhs.setZero();
+
+                for (unsigned int i = 0; i < _numberOfValues; ++i)
+                {
+                    for (unsigned int j = 0; j < n; ++j)
+                    {
+                        _rhs.col(j) += _functionSystem.Value(i, j) * _signals.col(i);
+                        for (unsigned int k = 0; k <= j; ++k)
+                        {
+                            _gram.col(j*n + k) += _functionSystem.Value(i, j) * _functionSystem.Value(i, k);
+                        }
+                    }
+                }
+
+                solveNormalEquations();
+
+                // The residual is formed explicitly, |s|^2 - c^T b would lose half of the digits
+                LaneVec squaredError = LaneVec::Zero();
+                LaneVec r;
+                for (unsigned int i = 0; i < _numberOfValues; ++i)
+                {
+                    r = _signals.col(i);
+                    for (unsigned int k = 0; k < n; ++k)
+                    {
+                        r -= _linParams.col(k) * _functionSystem.Value(i, k);
+                    }
+                    squaredError += r * r;
+                }
+                errors = squaredError.sqrt();
+            }
+
+            /*! \brief GetLinearParameters
+            *
+            * Returns the coefficients of the last evaluation, row l belongs to lane l.
+            */
+            LaneMatrix GetLinearParameters()
+            {
+                return _linParams;
+            }
+
+            /*! \brief GetApproximations
+            *
+            * Returns the approximations of the last evaluation, row l belongs to lane l.
+            */
+            LaneMatrix GetApproximations()
+            {
+                LaneMatrix ret = LaneMatrix::Zero(Lanes, _numberOfValues);
+                for (unsigned int i = 0; i < _numberOfValues; ++i)
+                {
+                    for (unsigned int k = 0; k < _degrees; ++k)
+                    {
+                        ret.col(i) += _linParams.col(k) * _functionSystem.Value(i, k);
+                    }
+                }
+                return ret;
+            }
+
+            unsigned long GetNumberOfBatchedEvaluations()
+            {
+                return _batchedEvaluations;
+            }
+
+            /*! \brief Fit
+            *
+            * Approximates every row of signals. initialParameters holds either one
+            * [dilatation, translation] row used for all problems, or one row per problem.
+            * The results are returned row by row in nonLinearParameters, linearParameters and errors.
+            * The problems are processed in batches of Lanes, the unused lanes of the last
+            * batch are masked out.
+            */
+            void Fit(const EMatrix<T>& signals, const EMatrix<T>& initialParameters,
+                     EMatrix<T>& nonLinearParameters, EMatrix<T>& linearParameters, EColVec<T>& errors)
+            {
+                const unsigned int numberOfProblems = signals.rows();
+                const int p = 2;
+
+                nonLinearParameters.resize(numberOfProblems, p);
+                linearParameters.resize(numberOfProblems, _degrees);
+                errors.resize(numberOfProblems);
+
+                BatchedNelderMead<T, Lanes, BatchedVariableProjection<T, Lanes> > optimizer;
+                std::vector<LaneMatrix> vertices(p + 1, LaneMatrix(Lanes, p));
+                LaneMatrix batchSignals(Lanes, _numberOfValues);
+                LaneVec batchErrors;
+
+                for (unsigned int first = 0; first < numberOfProblems; first += Lanes)
+                {
+                    LaneMask active;
+                    for (int l = 0; l < Lanes; ++l)
+                    {
+                        // Unused lanes repeat the last problem, so they stay well-conditioned
+                        unsigned int problem = (first + l < numberOfProblems) ? first + l : numberOfProblems - 1;
+                        active(l) = (first + l < numberOfProblems);
+
+                        batchSignals.row(l) = signals.row(problem).array();
+                        ERowVec<T> start = (initialParameters.rows() == 1) ? ERowVec<T>(initialParameters.row(0)) : ERowVec<T>(initialParameters.row(problem));
+
+                        for (int v = 0; v <= p; ++v)
+                        {
+                            vertices[v].row(l) = start.array();
+                            if (v > 0)
+                            {
+                                vertices[v](l, v-1) += _initialStep(v-1);
+                            }
+                        }
+                    }
+
+                    SetSignals(batchSignals);
+                    optimizer.Optimize(_maximumErrorForOptimisation, _maximumNumberOfIterationsForOptimisation, vertices, *this, active);
+
+                    // Final evaluation at the best vertices to get the matching coefficients
+                    LaneMatrix best = optimizer.GetPosition();
+                    Evaluate(best, batchErrors);
+
+                    for (int l = 0; l < Lanes && first + l < numberOfProblems; ++l)
+                    {
+                        nonLinearParameters.row(first + l) = best.row(l).matrix();
+                        linearParameters.row(first + l) = _linParams.row(l).matrix();
+                        errors(first + l) = batchErrors(l);
+                    }
+                }
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef __BEATSEGMENTER_H_INCLUDED__
+#define __BEATSEGMENTER_H_INCLUDED__
+
+#include <deque>
+#include <vector>
+#include "TypeDefs.h"
+#include "BoundedQueue.h"
+#include "PanTompkinsDetector.h"
+
+namespace APPRSDK
+{
+    /*! \brief Beat
+    *
+    * A beat cut out by BeatSegmenter: the window around the R peak resampled to the
+    * length of the function system, and the R peak in the window as initial translation.
+    */
+    template<typename T>
+    struct Beat
+    {
+        unsigned long index;
+        unsigned long position;
+        unsigned long begin;
+        ERowVec<T> window;
+        T translation;
+
+        Beat() : index(0), position(0), begin(0), translation(0)
+        {
+
+        }
+    };
+
+    /*! \brief BeatSegmenter
+    *
+    * Streaming front end of the approximation: the samples of a record are pushed once,
+    * the R peaks are detected on the fly (PanTompkinsDetector), and as soon as the samples
+    * after a peak arrived, the window [peak - before, peak + after] is taken from a ring
+    * buffer, linearly resampled to the length m of the function system and pushed into a
+    * BoundedQueue, where VarPro workers pick the beats up. The queue blocks when the workers
+    * fall behind, so the memory is bounded by the ring buffer and the queue capacity.
+    *
+    * Beats whose window starts before the record, or whose samples left the ring buffer
+    * (i.e. found very late by the search back of the detector) are dropped and counted.
+    */
+    template<typename T>
+    class BeatSegmenter
+    {
+        protected:
+            PanTompkinsDetector<T> _detector;
+            BoundedQueue<Beat<T> >* _queue;
+            unsigned long _before;
+            unsigned long _after;
+            unsigned int _length;
+
+            std::vector<T> _ring;
+            std::deque<unsigned long> _pending;
+            unsigned long _beats;
+            unsigned long _dropped;
+            Beat<T> _beat;
+
+            void emit(unsigned long peak, unsigned long position)
+            {
+                if (peak < _before || position - (peak - _before) > _ring.size())
+                {
+                    _dropped++;
+                    return;
+                }
+
+                unsigned long windowLength = _before + _after + 1;
+                double step = (_length > 1) ? (double)(windowLength - 1) / (_length - 1) : 0;
+                _beat.index = _beats++;
+                _beat.position = peak;
+                _beat.begin = peak - _before;
+                _beat.translation = (T)(_before / (step > 0 ? step : 1));
+                _beat.window.resize(_length);
+                for (unsigned int j = 0; j < _length; ++j)
+                {
+                    double s = j * step;
+                    unsigned long i = (unsigned long)s;
+                    i = (i + 1 < windowLength) ? i : windowLength - 2;
+                    T fraction = (T)(s - i);
+                    T left = _ring[(_beat.begin + i) % _ring.size()];
+                    T right = _ring[(_beat.begin + i + 1) % _ring.size()];
+                    _beat.window(j) = left + fraction * (right - left);
+                }
+                _queue->Push(_beat);
+            }
+
+        public:
+            /*! \brief Constructor
+            *
+            * queue: receives the beats, length: length m of the function system,
+            * frequency: sampling frequency (Hz), before / after: the window around the
+            * R peak in seconds.
+            */
+            BeatSegmenter(BoundedQueue<Beat<T> >* queue, unsigned int length, double frequency = 360, double before = 0.25, double after = 0.4)
+                : _detector(frequency), _queue(queue), _length(length < 2 ? 2 : length), _beats(0), _dropped(0)
+            {
+                _before = (unsigned long)(before * frequency + 0.5);
+                _after = (unsigned long)(after * frequency + 0.5);
+                _after = (_before + _after == 0) ? 1 : _after;
+
+                // Room for the window, the delay of the detector and a search back of up to 2 s
+                _ring.assign(_before + _after + 1 + _detector.GetMaximumDelay() + (unsigned long)(2 * frequency), (T)0);
+            }
+
+            PanTompkinsDetector<T>& GetDetector()
+            {
+                return _detector;
+            }
+
+            unsigned long GetNumberOfBeats()
+            {
+                return _beats;
+            }
+
+            unsigned long GetNumberOfDroppedBeats()
+            {
+                return _dropped;
+            }
+
+            /*! \brief Push
+            *
+            * Processes the next sample; may block while the queue is full.
+            */
+            void Push(T sample)
+            {
+                unsigned long n = _detector.GetPosition();
+                _ring[n % _ring.size()] = sample;
+                if (_detector.Push(sample))
+                {
+                    _pending.push_back(_detector.GetPeak());
+                }
+
+                while (!_pending.empty() && _pending.front() + _after <= n)
+                {
+                    emit(_pending.front(), n + 1);
+                    _pending.pop_front();
+                }
+            }
+
+            /*! \brief Push
+            *
+            * Processes a block of samples, i.e. a channel of a record reader block.
+            */
+            void Push(const ERowVecRef<T>& samples)
+            {
+                for (long i = 0; i < samples.cols(); ++i)
+                {
+                    Push(samples(i));
+                }
+            }
+
+            /*! \brief Finish
+            *
+            * Ends the record: beats still waiting for samples are dropped, and the queue is
+            * closed, so the workers stop when they took the remaining beats.
+            */
+            void Finish()
+            {
+                _dropped += _pending.size();
+                _pending.clear();
+                _queue->Close();
+            }
+    };
+}
+
+#endif
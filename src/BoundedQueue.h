@@ -0,0 +1,98 @@
+#ifndef __BOUNDEDQUEUE_H_INCLUDED__
+#define __BOUNDEDQUEUE_H_INCLUDED__
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace APPRSDK
+{
+    /*! \brief BoundedQueue
+    *
+    * Blocking queue of limited capacity for any number of producer and consumer threads.
+    * Unlike SnapshotQueue, no item is dropped: Push waits while the queue is full, so a
+    * fast producer is slowed down to the pace of the consumers and the memory stays bounded.
+    * Close wakes up everybody; the consumers get the remaining items, then Pop returns false.
+    */
+    template<typename Item>
+    class BoundedQueue
+    {
+        protected:
+            std::deque<Item> _items;
+            size_t _capacity;
+            bool _closed;
+            std::mutex _mutex;
+            std::condition_variable _notEmpty;
+            std::condition_variable _notFull;
+
+        public:
+            BoundedQueue(size_t capacity = 64) : _capacity(capacity == 0 ? 1 : capacity), _closed(false)
+            {
+
+            }
+
+            /*! \brief Push
+            *
+            * Waits for space and appends the item. Returns false if the queue is closed.
+            */
+            bool Push(const Item& item)
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                while (_items.size() >= _capacity && !_closed)
+                {
+                    _notFull.wait(lock);
+                }
+                if (_closed)
+                {
+                    return false;
+                }
+                _items.push_back(item);
+                _notEmpty.notify_one();
+                return true;
+            }
+
+            /*! \brief Pop
+            *
+            * Waits for an item and takes it out. Returns false if the queue is closed and empty.
+            */
+            bool Pop(Item& item)
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                while (_items.empty() && !_closed)
+                {
+                    _notEmpty.wait(lock);
+                }
+                if (_items.empty())
+                {
+                    return false;
+                }
+                std::swap(item, _items.front());
+                _items.pop_front();
+                _notFull.notify_one();
+                return true;
+            }
+
+            void Close()
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _closed = true;
+                _notEmpty.notify_all();
+                _notFull.notify_all();
+            }
+
+            bool IsClosed()
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _closed;
+            }
+
+            size_t GetSize()
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _items.size();
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,505 @@
+#ifndef __COEFFICIENTSTORE_H_INCLUDED__
+#define __COEFFICIENTSTORE_H_INCLUDED__
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "TypeDefs.h"
+#include "MappedFile.h"
+
+namespace APPRSDK
+{
+    /*! \brief Layout of the coefficient files
+    *
+    * The file starts with a CoefficientFileHeader, followed by blocks of blockSize beats
+    * (the last block may be shorter) and the index. A block of n beats is stored column
+    * by column, each column padded to 8 bytes:
+    * - timestamps: uint64_t[n] (non-decreasing, i.e. the sample position of the R peak)
+    * - degrees: uint32_t[n] (number of valid linear coefficients)
+    * - prd: T[n]
+    * - nonlinear parameters: T[n * nonLinearCapacity], parameter by parameter
+    * - linear coefficients: T[n * linearCapacity], coefficient by coefficient (unused ones are 0)
+    * The index holds a CoefficientBlockIndex per block, and the file ends with a
+    * CoefficientFileFooter, so a reader finds the index from the end of the file.
+    * All values are in native byte order.
+    */
+    struct CoefficientFileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t sampleSize;
+        uint32_t linearCapacity;
+        uint32_t nonLinearCapacity;
+        uint32_t blockSize;
+        uint32_t reserved;
+    };
+
+    struct CoefficientBlockIndex
+    {
+        uint64_t offset;
+        uint64_t firstBeat;
+        uint64_t numberOfBeats;
+        uint64_t firstTimestamp;
+        uint64_t lastTimestamp;
+    };
+
+    struct CoefficientFileFooter
+    {
+        uint64_t indexOffset;
+        uint64_t numberOfBlocks;
+        uint64_t numberOfBeats;
+        char magic[8];
+    };
+
+    const uint32_t coefficientFileVersion = 1;
+
+    /*! \brief CoefficientRecord
+    *
+    * The model of one beat.
+    */
+    template<typename T>
+    struct CoefficientRecord
+    {
+        uint64_t timestamp;
+        unsigned int degree;
+        T prd;
+        ERowVec<T> linearParameters;
+        ERowVec<T> nonLinearParameters;
+    };
+
+    /*! \brief CoefficientBlock
+    *
+    * Zero-copy view of a block of a mapped coefficient file: row j of linearParameters and
+    * nonLinearParameters belongs to beat firstBeat + j (column-major, so a column holds one
+    * coefficient of all beats of the block, i.e. for batched reconstruction).
+    */
+    template<typename T>
+    struct CoefficientBlock
+    {
+        uint64_t firstBeat;
+        Eigen::Map<const Eigen::Matrix<uint64_t, Eigen::Dynamic, 1> > timestamps;
+        Eigen::Map<const Eigen::Matrix<uint32_t, Eigen::Dynamic, 1> > degrees;
+        Eigen::Map<const EColVec<T> > prd;
+        Eigen::Map<const EMatrix<T>, 0, Eigen::OuterStride<> > nonLinearParameters;
+        Eigen::Map<const EMatrix<T>, 0, Eigen::OuterStride<> > linearParameters;
+
+        CoefficientBlock() : firstBeat(0), timestamps(0, 0), degrees(0, 0), prd(0, 0),
+                             nonLinearParameters(0, 0, 0, Eigen::OuterStride<>(1)), linearParameters(0, 0, 0, Eigen::OuterStride<>(1))
+        {
+
+        }
+    };
+
+    inline size_t coefficientColumnSize(size_t bytes)
+    {
+        return (bytes + 7) / 8 * 8;
+    }
+
+    /*! \brief CoefficientWriter
+    *
+    * Appends the beat models to a coefficient file. The beats are collected column by
+    * column in memory and written a block at a time; Close writes the last block and the
+    * index (a file that was not closed has no index and cannot be read).
+    */
+    template<typename T>
+    class CoefficientWriter
+    {
+        protected:
+            std::ofstream _file;
+            CoefficientFileHeader _header;
+            std::vector<CoefficientBlockIndex> _index;
+            uint64_t _numberOfBeats;
+
+            std::vector<uint64_t> _timestamps;
+            std::vector<uint32_t> _degrees;
+            std::vector<T> _prd;
+            EMatrix<T> _nonLinear;
+            EMatrix<T> _linear;
+
+            template<typename Value>
+            void writeColumn(const Value* values, size_t count)
+            {
+                static const char padding[8] = {0};
+                _file.write(reinterpret_cast<const char*>(values), count * sizeof(Value));
+                _file.write(padding, coefficientColumnSize(count * sizeof(Value)) - count * sizeof(Value));
+            }
+
+            void writeBlock()
+            {
+                size_t n = _timestamps.size();
+                if (n == 0)
+                {
+                    return;
+                }
+
+                CoefficientBlockIndex entry;
+                entry.offset = _file.tellp();
+                entry.firstBeat = _numberOfBeats - n;
+                entry.numberOfBeats = n;
+                entry.firstTimestamp = _timestamps.front();
+                entry.lastTimestamp = _timestamps.back();
+                _index.push_back(entry);
+
+                writeColumn(_timestamps.data(), n);
+                writeColumn(_degrees.data(), n);
+                writeColumn(_prd.data(), n);
+                for (uint32_t k = 0; k < _header.nonLinearCapacity; ++k)
+                {
+                    writeColumn(_nonLinear.col(k).data(), n);
+                }
+                for (uint32_t k = 0; k < _header.linearCapacity; ++k)
+                {
+                    writeColumn(_linear.col(k).data(), n);
+                }
+
+                _timestamps.clear();
+                _degrees.clear();
+                _prd.clear();
+            }
+
+        public:
+            CoefficientWriter() : _numberOfBeats(0)
+            {
+
+            }
+
+            ~CoefficientWriter()
+            {
+                Close();
+            }
+
+            /*! \brief Open
+            *
+            * Creates the file for models with up to linearCapacity coefficients and
+            * nonLinearCapacity nonlinear parameters, with blockSize beats per block.
+            */
+            bool Open(const std::string& filename, unsigned int linearCapacity, unsigned int nonLinearCapacity, unsigned int blockSize = 4096)
+            {
+                Close();
+
+                memset(&_header, 0, sizeof(_header));
+                memcpy(_header.magic, "APPRCOF1", 8);
+                _header.version = coefficientFileVersion;
+                _header.sampleSize = sizeof(T);
+                _header.linearCapacity = linearCapacity;
+                _header.nonLinearCapacity = nonLinearCapacity;
+                _header.blockSize = (blockSize == 0) ? 1 : blockSize;
+
+                _index.clear();
+                _numberOfBeats = 0;
+                _timestamps.reserve(_header.blockSize);
+                _degrees.reserve(_header.blockSize);
+                _prd.reserve(_header.blockSize);
+                _nonLinear.resize(_header.blockSize, nonLinearCapacity);
+                _linear.resize(_header.blockSize, linearCapacity);
+
+                _file.clear();
+                _file.open(filename.c_str(), std::ios::binary | std::ios::trunc);
+                _file.write(reinterpret_cast<const char*>(&_header), sizeof(_header));
+                return _file.good();
+            }
+
+            /*! \brief Append
+            *
+            * Appends the model of the next beat. The timestamps have to be non-decreasing.
+            * Coefficients beyond the capacities are cut off.
+            */
+            bool Append(uint64_t timestamp, const ERowVecRef<T>& linearParameters, const ERowVecRef<T>& nonLinearParameters, T prd)
+            {
+                if (!_file.is_open())
+                {
+                    return false;
+                }
+
+                size_t j = _timestamps.size();
+                unsigned int degree = std::min<unsigned int>(linearParameters.cols(), _header.linearCapacity);
+                unsigned int nonLinear = std::min<unsigned int>(nonLinearParameters.cols(), _header.nonLinearCapacity);
+                _timestamps.push_back(timestamp);
+                _degrees.push_back(degree);
+                _prd.push_back(prd);
+                _linear.row(j).setZero();
+                _linear.row(j).head(degree) = linearParameters.head(degree);
+                _nonLinear.row(j).setZero();
+                _nonLinear.row(j).head(nonLinear) = nonLinearParameters.head(nonLinear);
+                _numberOfBeats++;
+
+                if (_timestamps.size() == _header.blockSize)
+                {
+                    writeBlock();
+                }
+                return _file.good();
+            }
+
+            /*! \brief Append
+            *
+            * Appends the result of an approximator (i.e. VariableProjection after Varpro);
+            * the PRD is computed from its signal and approximation.
+            */
+            template<typename Approximator>
+            bool Append(uint64_t timestamp, Approximator& approximator)
+            {
+                ERowVec<T> signal = approximator.GetSignal();
+                T norm = signal.norm();
+                T prd = (norm > 0) ? (T)100 * (signal - approximator.GetApproximation()).norm() / norm : 0;
+                return Append(timestamp, approximator.GetLinearParameters(), approximator.GetNonLinearParameters(), prd);
+            }
+
+            unsigned long GetNumberOfBeats()
+            {
+                return _numberOfBeats;
+            }
+
+            /*! \brief Close
+            *
+            * Writes the pending beats and the index. Returns false if writing failed.
+            */
+            bool Close()
+            {
+                if (!_file.is_open())
+                {
+                    return true;
+                }
+
+                writeBlock();
+
+                CoefficientFileFooter footer;
+                memset(&footer, 0, sizeof(footer));
+                footer.indexOffset = _file.tellp();
+                footer.numberOfBlocks = _index.size();
+                footer.numberOfBeats = _numberOfBeats;
+                memcpy(footer.magic, "APPRIDX1", 8);
+                if (!_index.empty())
+                {
+                    _file.write(reinterpret_cast<const char*>(_index.data()), _index.size() * sizeof(CoefficientBlockIndex));
+                }
+                _file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+
+                bool ret = _file.good();
+                _file.close();
+                return ret;
+            }
+    };
+
+    /*! \brief CoefficientReader
+    *
+    * Reads a coefficient file through a memory mapping. As all blocks but the last hold
+    * blockSize beats, the model of any beat is found in O(1); a timestamp is found by a
+    * binary search in the index and in the timestamps of one block.
+    */
+    template<typename T>
+    class CoefficientReader
+    {
+        protected:
+            MappedFile _file;
+            const CoefficientFileHeader* _header;
+            const CoefficientBlockIndex* _index;
+            uint64_t _numberOfBlocks;
+            uint64_t _numberOfBeats;
+
+            // Checks that the entry describes block b of a file holding numberOfBeats beats and
+            // that its columns lie between the header and the index
+            bool validEntry(const CoefficientFileHeader* header, const CoefficientBlockIndex& entry, uint64_t b, uint64_t numberOfBlocks,
+                            uint64_t numberOfBeats, uint64_t indexOffset)
+            {
+                uint64_t n = entry.numberOfBeats;
+                if (n == 0 || n > header->blockSize || (b + 1 < numberOfBlocks && n != header->blockSize) ||
+                    entry.firstBeat != b * header->blockSize || (b + 1 == numberOfBlocks && entry.firstBeat + n != numberOfBeats) ||
+                    entry.offset < sizeof(CoefficientFileHeader) || entry.offset % 8 != 0 || entry.offset > indexOffset)
+                {
+                    return false;
+                }
+
+                uint64_t available = indexOffset - entry.offset;
+                uint64_t columns = (uint64_t)header->nonLinearCapacity + header->linearCapacity;
+                uint64_t columnSize = coefficientColumnSize(n * sizeof(T));
+                uint64_t fixedSize = coefficientColumnSize(n * sizeof(uint64_t)) + coefficientColumnSize(n * sizeof(uint32_t)) + columnSize;
+                return fixedSize <= available && columns <= (available - fixedSize) / columnSize;
+            }
+
+        public:
+            CoefficientReader() : _header(0), _index(0), _numberOfBlocks(0), _numberOfBeats(0)
+            {
+
+            }
+
+            /*! \brief Open
+            *
+            * Maps the file. Returns false if it is not a (closed) coefficient file of type T in
+            * this version of the format, or if its index does not match its blocks (i.e. the
+            * file is truncated or corrupted).
+            */
+            bool Open(const std::string& filename)
+            {
+                Close();
+                if (!_file.Open(filename) || _file.GetSize() < sizeof(CoefficientFileHeader) + sizeof(CoefficientFileFooter))
+                {
+                    Close();
+                    return false;
+                }
+
+                const char* data = _file.GetData();
+                size_t size = _file.GetSize();
+                const CoefficientFileHeader* header = reinterpret_cast<const CoefficientFileHeader*>(data);
+                const CoefficientFileFooter* footer = reinterpret_cast<const CoefficientFileFooter*>(data + size - sizeof(CoefficientFileFooter));
+                if (memcmp(header->magic, "APPRCOF1", 8) != 0 || memcmp(footer->magic, "APPRIDX1", 8) != 0 || header->version != coefficientFileVersion ||
+                    header->sampleSize != sizeof(T) || header->blockSize == 0 || footer->indexOffset < sizeof(CoefficientFileHeader) || footer->indexOffset > size ||
+                    footer->indexOffset % 8 != 0 || footer->numberOfBlocks > (size - sizeof(CoefficientFileFooter)) / sizeof(CoefficientBlockIndex) ||
+                    footer->indexOffset + footer->numberOfBlocks * sizeof(CoefficientBlockIndex) + sizeof(CoefficientFileFooter) != size)
+                {
+                    Close();
+                    return false;
+                }
+
+                // Get and FindBeat rely on the index, so every entry is checked once here
+                const CoefficientBlockIndex* index = reinterpret_cast<const CoefficientBlockIndex*>(data + footer->indexOffset);
+                if (footer->numberOfBlocks == 0 && footer->numberOfBeats != 0)
+                {
+                    Close();
+                    return false;
+                }
+                for (uint64_t b = 0; b < footer->numberOfBlocks; ++b)
+                {
+                    if (!validEntry(header, index[b], b, footer->numberOfBlocks, footer->numberOfBeats, footer->indexOffset))
+                    {
+                        Close();
+                        return false;
+                    }
+                }
+
+                _header = header;
+                _index = index;
+                _numberOfBlocks = footer->numberOfBlocks;
+                _numberOfBeats = footer->numberOfBeats;
+                return true;
+            }
+
+            void Close()
+            {
+                _file.Close();
+                _header = 0;
+                _index = 0;
+                _numberOfBlocks = 0;
+                _numberOfBeats = 0;
+            }
+
+            unsigned long GetNumberOfBeats()
+            {
+                return _numberOfBeats;
+            }
+
+            unsigned long GetNumberOfBlocks()
+            {
+                return _numberOfBlocks;
+            }
+
+            unsigned int GetBlockSize()
+            {
+                return _header ? _header->blockSize : 0;
+            }
+
+            unsigned int GetLinearCapacity()
+            {
+                return _header ? _header->linearCapacity : 0;
+            }
+
+            unsigned int GetNonLinearCapacity()
+            {
+                return _header ? _header->nonLinearCapacity : 0;
+            }
+
+            /*! \brief GetBlock
+            *
+            * Zero-copy view of the given block, valid while the reader is open.
+            */
+            bool GetBlock(unsigned long blockNumber, CoefficientBlock<T>& block)
+            {
+                if (blockNumber >= _numberOfBlocks)
+                {
+                    return false;
+                }
+
+                const CoefficientBlockIndex& entry = _index[blockNumber];
+                size_t n = entry.numberOfBeats;
+                const char* p = _file.GetData() + entry.offset;
+                block.firstBeat = entry.firstBeat;
+
+                new (&block.timestamps) Eigen::Map<const Eigen::Matrix<uint64_t, Eigen::Dynamic, 1> >(reinterpret_cast<const uint64_t*>(p), n);
+                p += coefficientColumnSize(n * sizeof(uint64_t));
+                new (&block.degrees) Eigen::Map<const Eigen::Matrix<uint32_t, Eigen::Dynamic, 1> >(reinterpret_cast<const uint32_t*>(p), n);
+                p += coefficientColumnSize(n * sizeof(uint32_t));
+                new (&block.prd) Eigen::Map<const EColVec<T> >(reinterpret_cast<const T*>(p), n);
+                p += coefficientColumnSize(n * sizeof(T));
+
+                // The columns of the matrices are padded to 8 bytes (float columns of odd length)
+                size_t columnSize = coefficientColumnSize(n * sizeof(T));
+                Eigen::OuterStride<> stride(columnSize / sizeof(T));
+                new (&block.nonLinearParameters) Eigen::Map<const EMatrix<T>, 0, Eigen::OuterStride<> >(reinterpret_cast<const T*>(p), n, _header->nonLinearCapacity, stride);
+                p += _header->nonLinearCapacity * columnSize;
+                new (&block.linearParameters) Eigen::Map<const EMatrix<T>, 0, Eigen::OuterStride<> >(reinterpret_cast<const T*>(p), n, _header->linearCapacity, stride);
+                return true;
+            }
+
+            /*! \brief Get
+            *
+            * The model of the given beat in O(1).
+            */
+            bool Get(unsigned long beat, CoefficientRecord<T>& record)
+            {
+                if (beat >= _numberOfBeats)
+                {
+                    return false;
+                }
+
+                CoefficientBlock<T> block;
+                if (!GetBlock(beat / _header->blockSize, block))
+                {
+                    return false;
+                }
+
+                unsigned long j = beat - block.firstBeat;
+                record.timestamp = block.timestamps(j);
+                record.degree = block.degrees(j);
+                record.prd = block.prd(j);
+                record.linearParameters = block.linearParameters.row(j).head(record.degree);
+                record.nonLinearParameters = block.nonLinearParameters.row(j);
+                return true;
+            }
+
+            /*! \brief FindBeat
+            *
+            * The first beat with a timestamp not before the given one (GetNumberOfBeats()
+            * if there is none).
+            */
+            unsigned long FindBeat(uint64_t timestamp)
+            {
+                unsigned long low = 0, high = _numberOfBlocks;
+                while (low < high)
+                {
+                    unsigned long middle = (low + high) / 2;
+                    if (_index[middle].lastTimestamp < timestamp)
+                    {
+                        low = middle + 1;
+                    }
+                    else
+                    {
+                        high = middle;
+                    }
+                }
+                if (low == _numberOfBlocks)
+                {
+                    return _numberOfBeats;
+                }
+
+                CoefficientBlock<T> block;
+                GetBlock(low, block);
+                const uint64_t* begin = block.timestamps.data();
+                return block.firstBeat + (std::lower_bound(begin, begin + block.timestamps.size(), timestamp) - begin);
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,293 @@
+#ifndef __CROSSCORRELATIONINITIALIZER_H_INCLUDED__
+#define __CROSSCORRELATIONINITIALIZER_H_INCLUDED__
+
+#include <math.h>
+#include "stdafx.h"
+#include "fasttransforms.h"
+#include "ap.h"
+#include "FunctionSystemDerivative.h"
+
+namespace APPRSDK
+{
+    /*! \brief CrossCorrelationInitializer
+    *
+    * The CrossCorrelationInitializer class estimates a starting dilatation and
+    * translation for the nonlinear optimization. The first few functions of the
+    * function system are generated at a set of candidate dilatations, centered
+    * in the middle of the window, and cross-correlated with the signal using the
+    * FFT based correlation of ALGLIB. The lag and dilatation for which the
+    * correlated functions capture the most energy of the signal is used as the
+    * estimate. The result can be passed to VariableProjection through
+    * SetNonLinParams and SetInitalParametersForOptimiser.
+    */
+    template<typename T>
+    class CrossCorrelationInitializer
+    {
+        protected:
+            ERowVec<T> _candidateDilatations;
+            ERowVec<T> _estimate;
+            unsigned int _numberOfCorrelatedFunctions;
+            T _dilatationStep;
+            T _score;
+
+            alglib::real_1d_array toAlgArray(ERowVec<T> v);
+            ERowVec<T> defaultCandidateDilatations(unsigned int numberOfValues, unsigned int degree);
+
+        public:
+            CrossCorrelationInitializer();
+
+            void SetCandidateDilatations(ERowVec<T> candidates);
+            void SetNumberOfCorrelatedFunctions(unsigned int n);
+
+            ERowVec<T> Estimate(ERowVec<T> signal, FunctionSystemDerivative<T>* functionSystem);
+            EMatrix<T> GetInitialParameters(unsigned int numberOfParamVecs);
+            ERowVec<T> GetEstimate();
+            T GetScore();
+
+            /*! \brief Apply
+            *
+            * Feeds the last estimate into an approximator (i.e. VariableProjection).
+            * This has to be called after SelectOptimiser, as selecting an optimiser
+            * with initialisation overwrites the initial parameters.
+            */
+            template<typename Approximator>
+            void Apply(Approximator* approximator, unsigned int numberOfParamVecs)
+            {
+                approximator->SetNonLinParams(_estimate);
+                approximator->SetInitalParametersForOptimiser(GetInitialParameters(numberOfParamVecs));
+            }
+    };
+
+    /*! \brief Constructor
+    */
+    template<typename T>
+    CrossCorrelationInitializer<T>::CrossCorrelationInitializer()
+    {
+        _candidateDilatations.resize(0);
+        _estimate.resize(0);
+        _numberOfCorrelatedFunctions = 3;
+        _dilatationStep = (T)0.1;
+        _score = 0;
+    }
+
+    /*! \brief SetCandidateDilatations
+    *
+    * Sets the dilatations at which the function system is correlated with the signal.
+    * If no candidates are set, a geometric grid is chosen based on the window length
+    * and the degree of the function system.
+    */
+    template<typename T>
+    void CrossCorrelationInitializer<T>::SetCandidateDilatations(ERowVec<T> candidates)
+    {
+        _candidateDilatations = candidates;
+    }
+
+    /*! \brief SetNumberOfCorrelatedFunctions
+    *
+    * Sets how many of the lowest order functions are correlated with the signal.
+    */
+    template<typename T>
+    void CrossCorrelationInitializer<T>::SetNumberOfCorrelatedFunctions(unsigned int n)
+    {
+        _numberOfCorrelatedFunctions = n;
+    }
+
+    /*! \brief GetEstimate
+    *
+    * Returns the last estimated [dilatation, translation] pair.
+    */
+    template<typename T>
+    ERowVec<T> CrossCorrelationInitializer<T>::GetEstimate()
+    {
+        return _estimate;
+    }
+
+    /*! \brief GetScore
+    *
+    * Returns the signal energy captured by the correlated functions at the estimate.
+    */
+    template<typename T>
+    T CrossCorrelationInitializer<T>::GetScore()
+    {
+        return _score;
+    }
+
+    /*! \brief toAlgArray
+    *
+    * Converts an Eigen row vector to an ALGLIB array.
+    */
+    template<typename T>
+    alglib::real_1d_array CrossCorrelationInitializer<T>::toAlgArray(ERowVec<T> v)
+    {
+        Eigen::Matrix<double, 1, Eigen::Dynamic> d = v.template cast<double>();
+        alglib::real_1d_array ret;
+        ret.setcontent(d.cols(), d.data());
+        return ret;
+    }
+
+    /*! \brief defaultCandidateDilatations
+    *
+    * The widest candidate spreads the whole function system over the window, the
+    * narrowest one corresponds to a unit dilatation. The candidates in between
+    * are spaced geometrically.
+    */
+    template<typename T>
+    ERowVec<T> CrossCorrelationInitializer<T>::defaultCandidateDilatations(unsigned int numberOfValues, unsigned int degree)
+    {
+        const int numberOfCandidates = 8;
+        T minDilatation = sqrt((T)(2*degree + 1)) / ((T)numberOfValues / (T)2.0);
+        T maxDilatation = (T)1.0;
+
+        if (minDilatation > maxDilatation)
+        {
+            minDilatation = maxDilatation;
+        }
+
+        ERowVec<T> ret;
+        ret.resize(numberOfCandidates);
+        for (int i = 0; i < numberOfCandidates; ++i)
+        {
+            ret(i) = minDilatation * pow(maxDilatation / minDilatation, (T)i / (T)(numberOfCandidates - 1));
+        }
+
+        return ret;
+    }
+
+    /*! \brief Estimate
+    *
+    * Estimates the dilatation and translation of the function system for the given signal.
+    * The function system is left in the state of the last candidate, so the caller should
+    * apply its own nonlinear parameters afterwards (Varpro does this on start).
+    * Returns the estimate as [dilatation, translation].
+    */
+    template<typename T>
+    ERowVec<T> CrossCorrelationInitializer<T>::Estimate(ERowVec<T> signal, FunctionSystemDerivative<T>* functionSystem)
+    {
+        const int N = signal.cols();
+        const int center = N/2;
+        const unsigned int degree = functionSystem->GetFunctionSystem().cols();
+        const unsigned int K = (_numberOfCorrelatedFunctions < degree) ? _numberOfCorrelatedFunctions : degree;
+
+        ERowVec<T> candidates = _candidateDilatations;
+        if (candidates.size() == 0)
+        {
+            candidates = defaultCandidateDilatations(N, degree);
+        }
+
+        alglib::real_1d_array algSignal = toAlgArray(signal);
+        alglib::real_1d_array algPattern;
+        alglib::real_1d_array corr;
+
+        ERowVec<T> params;
+        params.resize(2);
+
+        T bestScore = -1;
+        T bestDilatation = candidates(0);
+        T bestLag = 0;
+
+        for (int c = 0; c < candidates.cols(); ++c)
+        {
+            params(0) = candidates(c);
+            params(1) = center;
+            functionSystem->ApplyNonLinearParameters(params);
+            EMatrix<T> funSys = functionSystem->GetFunctionSystem();
+
+            // score(lag) is the energy of the signal captured by the shifted functions
+            ERowVec<T> score = ERowVec<T>::Zero(N);
+
+            for (unsigned int k = 0; k < K; ++k)
+            {
+                ERowVec<T> pattern = funSys.col(k).transpose();
+                T patternNorm = pattern.squaredNorm();
+                if (patternNorm <= 0)
+                {
+                    continue;
+                }
+
+                algPattern = toAlgArray(pattern);
+                alglib::corrr1d(algSignal, N, algPattern, N, corr);
+
+                // Only lags which keep the center of the function system inside the window are considered
+                for (int i = 0; i < N; ++i)
+                {
+                    int lag = i - center;
+                    T r = (lag >= 0) ? (T)corr[lag] : (T)corr[2*N - 1 + lag];
+                    score(i) += r*r / patternNorm;
+                }
+            }
+
+            int bestIndex;
+            T maxScore = score.maxCoeff(&bestIndex);
+
+            if (maxScore > bestScore)
+            {
+                bestScore = maxScore;
+                bestDilatation = candidates(c);
+
+                // Parabolic interpolation around the peak for a sub-sample translation
+                T offset = 0;
+                if (bestIndex > 0 && bestIndex < N-1)
+                {
+                    T denom = score(bestIndex-1) - 2*score(bestIndex) + score(bestIndex+1);
+                    if (denom < 0)
+                    {
+                        offset = (T)0.5 * (score(bestIndex-1) - score(bestIndex+1)) / denom;
+                    }
+                }
+                bestLag = bestIndex + offset;
+            }
+        }
+
+        // The dilatation step of the initial simplex is the spacing of the candidate grid
+        if (candidates.cols() > 1)
+        {
+            _dilatationStep = (candidates.maxCoeff() - candidates.minCoeff()) / (T)(candidates.cols() - 1);
+        }
+        else
+        {
+            _dilatationStep = (T)0.1 * bestDilatation;
+        }
+
+        _score = bestScore;
+        _estimate.resize(2);
+        _estimate(0) = bestDilatation;
+        _estimate(1) = bestLag;
+
+        return _estimate;
+    }
+
+    /*! \brief GetInitialParameters
+    *
+    * Returns starting points for the optimiser around the last estimate. The first row is
+    * the estimate itself, every further row perturbs one parameter: the dilatation by the
+    * candidate grid spacing and the translation by one unit of the dilated function system.
+    */
+    template<typename T>
+    EMatrix<T> CrossCorrelationInitializer<T>::GetInitialParameters(unsigned int numberOfParamVecs)
+    {
+        EMatrix<T> ret;
+        ret.resize(numberOfParamVecs, _estimate.cols());
+
+        for (unsigned int i = 0; i < numberOfParamVecs; ++i)
+        {
+            ret.row(i) = _estimate;
+            if (i == 0)
+            {
+                continue;
+            }
+
+            if ((i-1) % 2 == 0)
+            {
+                ret(i, 0) += _dilatationStep;
+            }
+            else
+            {
+                ret(i, 1) += (T)1.0 / _estimate(0);
+            }
+        }
+
+        return ret;
+    }
+}
+
+#endif
@@ -0,0 +1,218 @@
+#ifndef __DOGLEG_H_INCLUDED__
+#define __DOGLEG_H_INCLUDED__
+
+#include <Eigen/QR>
+#include "ApproxStrategyBase.h"
+
+namespace APPRSDK
+{
+    /*! \brief Dogleg
+    *
+    * This class implements the IApproxStrategy interface with Powell's dogleg
+    * trust region method. Like GaussNewton, it needs the residual (GetResidual) and
+    * the Jacobian (GetJacobian) of the last evaluated point from the objective.
+    *
+    * In every iteration the step is the Gauss-Newton step if it fits into the trust
+    * region, otherwise the point where the path from the Cauchy (steepest descent)
+    * point towards the Gauss-Newton point leaves the region. The radius is adapted by
+    * the ratio of the actual and the predicted decrease of 1/2 |r|^2, so rejected
+    * steps shrink the region and the method becomes damped automatically.
+    * Trial points are projected into the boundaries, if they were set.
+    */
+    template<typename T, typename ToBeMinimizedClass>
+    class Dogleg : public ApproxStrategyBase<T, ToBeMinimizedClass>
+    {
+        protected:
+            T _stepTolerance;
+            T _initialRadius;
+
+            T _radius;
+            EColVec<T> _residual;
+            EMatrix<T> _jacobian;
+
+            /*! \brief step
+            *
+            * Returns the dogleg step for the given residual, Jacobian and radius.
+            * atBoundary is set if the step was cut to the trust region.
+            */
+            EColVec<T> step(const EColVec<T>& r, const EMatrix<T>& J, T radius, bool& atBoundary)
+            {
+                EColVec<T> gn = J.colPivHouseholderQr().solve(-r);
+                atBoundary = false;
+
+                if (gn.norm() <= radius)
+                {
+                    return gn;
+                }
+
+                atBoundary = true;
+
+                EColVec<T> g = J.transpose() * r;
+                T Jg = (J * g).squaredNorm();
+                if (Jg == 0)
+                {
+                    return gn * (radius / gn.norm());
+                }
+
+                EColVec<T> sd = -(g.squaredNorm() / Jg) * g;
+                if (sd.norm() >= radius)
+                {
+                    return sd * (radius / sd.norm());
+                }
+
+                // sd + tau (gn - sd) with |sd + tau (gn - sd)| = radius
+                EColVec<T> d = gn - sd;
+                T a = d.squaredNorm();
+                T b = 2 * sd.dot(d);
+                T c = sd.squaredNorm() - radius * radius;
+                T tau = (-b + sqrt(b * b - 4 * a * c)) / (2 * a);
+
+                return sd + tau * d;
+            }
+
+        public:
+            Dogleg() : _stepTolerance((T)1e-8), _initialRadius(0), _radius(0)
+            {
+
+            }
+
+            /*! \brief GetState
+            *
+            * Exports the position, its error, the trust radius (as damping) and the linearization.
+            */
+            OptimizerState<T> GetState()
+            {
+                OptimizerState<T> ret = ApproxStrategyBase<T, ToBeMinimizedClass>::GetState();
+                ret.strategy = "DL";
+                ret.damping = _radius;
+                ret.residual = _residual.transpose();
+                ret.jacobian = _jacobian;
+                return ret;
+            }
+
+            /*! \brief SetStepTolerance
+            *
+            * The iteration stops when the trust radius or the relative length of the
+            * accepted step falls below the given value.
+            */
+            void SetStepTolerance(T tolerance)
+            {
+                _stepTolerance = tolerance;
+            }
+
+            /*! \brief SetInitialRadius
+            *
+            * Sets the initial trust radius. 0 (default) uses the length of the first
+            * Gauss-Newton step.
+            */
+            void SetInitialRadius(T radius)
+            {
+                _initialRadius = radius;
+            }
+
+            void Optimize(T maxError, unsigned int maxIterations, EMatrix<T> inputParameters, ToBeMinimizedClass minObjPtr)
+            {
+                this->_maxIterations = maxIterations;
+                this->_currentIteration = 0;
+                this->_maxError = maxError;
+                this->_minObjPtr = minObjPtr;
+                this->_budget.Start();
+
+                OptimizerState<T> state;
+                if (this->takeResumeState("DL", inputParameters.cols(), state))
+                {
+                    this->_currentPosition = state.points.row(0);
+                    _radius = state.damping;
+                }
+                else
+                {
+                    this->_currentPosition = inputParameters.row(0);
+                    _radius = _initialRadius;
+                }
+                this->projectToBoundaries(this->_currentPosition);
+
+                if (!state.IsEmpty() && this->isReusable(state.values(0)) && state.jacobian.rows() == state.residual.cols())
+                {
+                    this->_currentError = state.values(0);
+                    _residual = state.residual.transpose();
+                    _jacobian = state.jacobian;
+                }
+                else
+                {
+                    this->_currentError = this->evaluate(this->_currentPosition);
+                    _residual = this->_minObjPtr->GetResidual().transpose();
+                    _jacobian = this->_minObjPtr->GetJacobian();
+                }
+
+                // A radius that already collapsed (i.e. in the state of a converged fit) is reset
+                if (_radius <= _stepTolerance * (this->_currentPosition.norm() + _stepTolerance))
+                {
+                    _radius = _jacobian.colPivHouseholderQr().solve(-_residual).norm();
+                }
+                StopReason reason = MaxIterationsReached;
+
+                while (this->_currentIteration < this->_maxIterations && !this->_budget.IsExhausted())
+                {
+                    if (this->_currentError <= this->_maxError)
+                    {
+                        reason = MaxErrorReached;
+                        break;
+                    }
+
+                    if (_radius <= _stepTolerance * (this->_currentPosition.norm() + _stepTolerance))
+                    {
+                        reason = Converged;
+                        break;
+                    }
+
+                    this->_currentIteration++;
+
+                    bool atBoundary;
+                    EColVec<T> d = step(_residual, _jacobian, _radius, atBoundary);
+                    ERowVec<T> trial = this->_currentPosition + d.transpose();
+                    this->projectToBoundaries(trial);
+                    T trialError = this->evaluate(trial);
+
+                    // The model decrease of the step actually taken, which the projection may have shortened
+                    EColVec<T> taken = (trial - this->_currentPosition).transpose();
+                    T predicted = (_residual.squaredNorm() - (_residual + _jacobian * taken).squaredNorm()) / 2;
+                    T actual = (this->_currentError * this->_currentError - trialError * trialError) / 2;
+                    T rho = (predicted > 0) ? actual / predicted : -1;
+
+                    if (rho < (T)0.25)
+                    {
+                        _radius /= 4;
+                    }
+                    else if (rho > (T)0.75 && atBoundary)
+                    {
+                        _radius *= 2;
+                    }
+
+                    if (trialError < this->_currentError)
+                    {
+                        T stepLength = (trial - this->_currentPosition).norm();
+
+                        this->_currentPosition = trial;
+                        this->_currentError = trialError;
+                        _residual = this->_minObjPtr->GetResidual().transpose();
+                        _jacobian = this->_minObjPtr->GetJacobian();
+
+                        if (stepLength <= _stepTolerance * (this->_currentPosition.norm() + _stepTolerance))
+                        {
+                            reason = Converged;
+                            break;
+                        }
+                    }
+                }
+
+                if (this->_currentError <= this->_maxError)
+                {
+                    reason = MaxErrorReached;
+                }
+
+                this->finish(reason);
+            }
+    };
+}
+
+#endif
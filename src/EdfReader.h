@@ -0,0 +1,235 @@
+#ifndef __EDFREADER_H_INCLUDED__
+#define __EDFREADER_H_INCLUDED__
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "IRecordReader.h"
+
+namespace APPRSDK
+{
+    /*! \brief EdfReader
+    *
+    * Streaming reader of EDF and EDF+ files: the header is parsed, the data records are
+    * read one at a time (a data record usually holds one second), so only one data record
+    * is in memory. The channels of a block have to share the sampling frequency: by default
+    * the ordinary signals with the frequency of the first one are read, the EDF+ annotation
+    * signal is skipped. The samples are 16 bit little-endian; each channel is scaled to
+    * physical units with one Eigen expression per data record.
+    */
+    template<typename T>
+    class EdfReader : public IRecordReader<T>
+    {
+        protected:
+            std::ifstream _file;
+            std::string _filename;
+            unsigned long _headerSize;
+            unsigned long _numberOfRecords;
+            double _recordDuration;
+
+            // All signals of the file
+            std::vector<std::string> _labels;
+            std::vector<unsigned long> _samplesPerRecord;
+            std::vector<unsigned long> _signalOffset;
+            std::vector<double> _scale;
+            std::vector<double> _offset;
+            unsigned long _recordSamples;
+
+            // Selected channels
+            std::vector<unsigned int> _channels;
+
+            std::vector<int16_t> _record;
+            unsigned long _recordIndex;
+            unsigned long _recordPosition;
+
+            static std::string field(const std::vector<char>& header, unsigned long offset, unsigned long length)
+            {
+                std::string ret(header.begin() + offset, header.begin() + offset + length);
+                ret.erase(ret.find_last_not_of(' ') + 1);
+                return ret;
+            }
+
+            bool readRecord()
+            {
+                if (_recordIndex >= _numberOfRecords)
+                {
+                    return false;
+                }
+                _file.read(reinterpret_cast<char*>(_record.data()), _recordSamples * sizeof(int16_t));
+                if ((unsigned long)_file.gcount() != _recordSamples * sizeof(int16_t))
+                {
+                    return false;
+                }
+                littleEndianToHost(_record.data(), _recordSamples);
+                _recordIndex++;
+                _recordPosition = 0;
+                return true;
+            }
+
+        public:
+            EdfReader() : _headerSize(0), _numberOfRecords(0), _recordDuration(0), _recordSamples(0), _recordIndex(0), _recordPosition(0)
+            {
+
+            }
+
+            /*! \brief Open
+            *
+            * Opens the file and parses its header. Returns false if it is not an EDF file.
+            */
+            bool Open(const std::string& filename)
+            {
+                _file.close();
+                _file.clear();
+                _file.open(filename.c_str(), std::ios::binary);
+                _filename = filename;
+
+                std::vector<char> header(256);
+                if (!_file.read(header.data(), header.size()) || field(header, 0, 8) != "0")
+                {
+                    return false;
+                }
+                _headerSize = atol(field(header, 184, 8).c_str());
+                _numberOfRecords = atol(field(header, 236, 8).c_str());
+                _recordDuration = atof(field(header, 244, 8).c_str());
+                unsigned long signals = atol(field(header, 252, 4).c_str());
+                if (signals == 0 || _headerSize != 256 * (signals + 1))
+                {
+                    return false;
+                }
+
+                // The signal header holds each field for all signals, one after the other
+                header.resize(256 * signals);
+                if (!_file.read(header.data(), header.size()))
+                {
+                    return false;
+                }
+
+                _labels.resize(signals);
+                _samplesPerRecord.resize(signals);
+                _signalOffset.resize(signals);
+                _scale.resize(signals);
+                _offset.resize(signals);
+                _recordSamples = 0;
+                for (unsigned long s = 0; s < signals; ++s)
+                {
+                    _labels[s] = field(header, 16 * s, 16);
+                    double physicalMin = atof(field(header, 104 * signals + 8 * s, 8).c_str());
+                    double physicalMax = atof(field(header, 112 * signals + 8 * s, 8).c_str());
+                    double digitalMin = atof(field(header, 120 * signals + 8 * s, 8).c_str());
+                    double digitalMax = atof(field(header, 128 * signals + 8 * s, 8).c_str());
+                    _samplesPerRecord[s] = atol(field(header, 216 * signals + 8 * s, 8).c_str());
+
+                    _scale[s] = (digitalMax == digitalMin) ? 1 : (physicalMax - physicalMin) / (digitalMax - digitalMin);
+                    _offset[s] = physicalMin - digitalMin * _scale[s];
+                    _signalOffset[s] = _recordSamples;
+                    _recordSamples += _samplesPerRecord[s];
+                }
+                _record.resize(_recordSamples);
+
+                _channels.clear();
+                for (unsigned int s = 0; s < signals; ++s)
+                {
+                    if (_labels[s] != "EDF Annotations" && (_channels.empty() || _samplesPerRecord[s] == _samplesPerRecord[_channels[0]]))
+                    {
+                        _channels.push_back(s);
+                    }
+                }
+
+                return !_channels.empty() && Rewind();
+            }
+
+            /*! \brief SelectChannels
+            *
+            * Selects the signals (indices into all signals of the file) read into the blocks.
+            * Returns false if they do not exist or do not share the sampling frequency.
+            */
+            bool SelectChannels(const std::vector<unsigned int>& channels)
+            {
+                for (unsigned int c = 0; c < channels.size(); ++c)
+                {
+                    if (channels[c] >= _labels.size() || _samplesPerRecord[channels[c]] != _samplesPerRecord[channels[0]])
+                    {
+                        return false;
+                    }
+                }
+                _channels = channels;
+                return !_channels.empty() && Rewind();
+            }
+
+            unsigned int GetNumberOfSignals()
+            {
+                return _labels.size();
+            }
+
+            std::string GetSignalLabel(unsigned int signal)
+            {
+                return _labels[signal];
+            }
+
+            unsigned int GetNumberOfChannels()
+            {
+                return _channels.size();
+            }
+
+            std::string GetChannelName(unsigned int channel)
+            {
+                return _labels[_channels[channel]];
+            }
+
+            double GetSamplingFrequency()
+            {
+                return (_channels.empty() || _recordDuration <= 0) ? 0 : _samplesPerRecord[_channels[0]] / _recordDuration;
+            }
+
+            unsigned long GetLength()
+            {
+                return _channels.empty() ? 0 : _numberOfRecords * _samplesPerRecord[_channels[0]];
+            }
+
+            unsigned long ReadBlock(ERowMajorMatrix<T>& block, unsigned long maxLength)
+            {
+                if (_channels.empty())
+                {
+                    return 0;
+                }
+
+                unsigned long samplesPerRecord = _samplesPerRecord[_channels[0]];
+                block.resize(_channels.size(), maxLength);
+                unsigned long length = 0;
+                while (length < maxLength)
+                {
+                    if (_recordPosition == samplesPerRecord && !readRecord())
+                    {
+                        break;
+                    }
+
+                    unsigned long count = std::min(maxLength - length, samplesPerRecord - _recordPosition);
+                    for (unsigned int c = 0; c < _channels.size(); ++c)
+                    {
+                        unsigned int s = _channels[c];
+                        Eigen::Map<const Eigen::Matrix<int16_t, 1, Eigen::Dynamic> > samples(_record.data() + _signalOffset[s] + _recordPosition, count);
+                        block.row(c).segment(length, count) = ((samples.cast<T>().array() * (T)_scale[s]) + (T)_offset[s]).matrix();
+                    }
+                    _recordPosition += count;
+                    length += count;
+                }
+
+                block.conservativeResize(Eigen::NoChange, length);
+                return length;
+            }
+
+            bool Rewind()
+            {
+                _file.clear();
+                _file.seekg(_headerSize);
+                _recordIndex = 0;
+                _recordPosition = _channels.empty() ? 0 : _samplesPerRecord[_channels[0]];
+                return _file.good();
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,225 @@
+#ifndef __EVALUATIONCACHE_H_INCLUDED__
+#define __EVALUATIONCACHE_H_INCLUDED__
+
+#include <vector>
+#include "TypeDefs.h"
+
+namespace APPRSDK
+{
+    /*! \brief CachedEvaluation
+    *
+    * Everything the objective computes for one nonlinear parameter vector.
+    */
+    template<typename T>
+    struct CachedEvaluation
+    {
+        ERowVec<T> parameters;
+        T error;
+        ERowVec<T> residual;
+        ERowVec<T> linearParameters;
+        ERowVec<T> approximation;
+        EMatrix<T> jacobian;
+        unsigned long lastUse;
+    };
+
+    /*! \brief EvaluationCache
+    *
+    * Small memo cache of objective evaluations keyed by the nonlinear parameter vector.
+    * Optimizers tend to evaluate the same point several times (final evaluations,
+    * re-evaluations of simplex vertices, etc.), these become lookups. Keys either
+    * match exactly (tolerance of 0) or if each coordinate is within the tolerance.
+    * When the cache is full the least recently used entry is replaced.
+    */
+    template<typename T>
+    class EvaluationCache
+    {
+        protected:
+            std::vector<CachedEvaluation<T> > _entries;
+            unsigned int _capacity;
+            T _tolerance;
+            unsigned long _hits;
+            unsigned long _misses;
+            unsigned long _clock;
+
+            bool matches(const ERowVec<T>& a, const ERowVecRef<T>& b);
+
+        public:
+            EvaluationCache(unsigned int capacity = 16, T tolerance = 0);
+
+            const CachedEvaluation<T>* Lookup(const ERowVecRef<T>& parameters);
+            void Insert(const CachedEvaluation<T>& evaluation);
+            void Clear();
+
+            void SetCapacity(unsigned int capacity);
+            void SetTolerance(T tolerance);
+
+            unsigned int GetCapacity();
+            T GetTolerance();
+            unsigned long GetHits();
+            unsigned long GetMisses();
+            double GetHitRate();
+    };
+
+    /*! \brief Constructor
+    */
+    template<typename T>
+    EvaluationCache<T>::EvaluationCache(unsigned int capacity, T tolerance)
+    {
+        _capacity = capacity;
+        _tolerance = tolerance;
+        _hits = 0;
+        _misses = 0;
+        _clock = 0;
+        _entries.reserve(capacity);
+    }
+
+    /*! \brief matches
+    *
+    * Compares two keys coordinate-wise with the set tolerance.
+    */
+    template<typename T>
+    bool EvaluationCache<T>::matches(const ERowVec<T>& a, const ERowVecRef<T>& b)
+    {
+        if (a.cols() != b.cols())
+        {
+            return false;
+        }
+
+        if (_tolerance == 0)
+        {
+            return a == b;
+        }
+
+        return ((a - b).cwiseAbs().maxCoeff() <= _tolerance);
+    }
+
+    /*! \brief Lookup
+    *
+    * Looks up the evaluation stored for the given parameters. Returns 0 on a miss. The
+    * entry is not copied; the pointer is valid until the next Insert, Clear or SetCapacity.
+    */
+    template<typename T>
+    const CachedEvaluation<T>* EvaluationCache<T>::Lookup(const ERowVecRef<T>& parameters)
+    {
+        for (unsigned int i = 0; i < _entries.size(); ++i)
+        {
+            if (matches(_entries[i].parameters, parameters))
+            {
+                _entries[i].lastUse = ++_clock;
+                _hits++;
+                return &_entries[i];
+            }
+        }
+
+        _misses++;
+        return 0;
+    }
+
+    /*! \brief Insert
+    *
+    * Stores an evaluation, replacing the least recently used one if the cache is full.
+    */
+    template<typename T>
+    void EvaluationCache<T>::Insert(const CachedEvaluation<T>& evaluation)
+    {
+        if (_capacity == 0)
+        {
+            return;
+        }
+
+        if (_entries.size() < _capacity)
+        {
+            _entries.push_back(evaluation);
+            _entries.back().lastUse = ++_clock;
+            return;
+        }
+
+        unsigned int oldest = 0;
+        for (unsigned int i = 1; i < _entries.size(); ++i)
+        {
+            if (_entries[i].lastUse < _entries[oldest].lastUse)
+            {
+                oldest = i;
+            }
+        }
+
+        _entries[oldest] = evaluation;
+        _entries[oldest].lastUse = ++_clock;
+    }
+
+    /*! \brief Clear
+    *
+    * Drops the stored evaluations. Has to be called whenever the objective changes
+    * (new signal, weights or function system). The statistics are kept.
+    */
+    template<typename T>
+    void EvaluationCache<T>::Clear()
+    {
+        _entries.clear();
+    }
+
+    /*! \brief SetCapacity
+    *
+    * Sets the maximal number of stored evaluations. A capacity of 0 disables the cache.
+    */
+    template<typename T>
+    void EvaluationCache<T>::SetCapacity(unsigned int capacity)
+    {
+        _capacity = capacity;
+        if (_entries.size() > _capacity)
+        {
+            _entries.clear();
+        }
+    }
+
+    /*! \brief SetTolerance
+    *
+    * Sets the coordinate-wise tolerance of the key matching. 0 means exact matching.
+    */
+    template<typename T>
+    void EvaluationCache<T>::SetTolerance(T tolerance)
+    {
+        _tolerance = tolerance;
+    }
+
+    template<typename T>
+    unsigned int EvaluationCache<T>::GetCapacity()
+    {
+        return _capacity;
+    }
+
+    template<typename T>
+    T EvaluationCache<T>::GetTolerance()
+    {
+        return _tolerance;
+    }
+
+    template<typename T>
+    unsigned long EvaluationCache<T>::GetHits()
+    {
+        return _hits;
+    }
+
+    template<typename T>
+    unsigned long EvaluationCache<T>::GetMisses()
+    {
+        return _misses;
+    }
+
+    /*! \brief GetHitRate
+    *
+    * Returns the ratio of lookups answered from the cache.
+    */
+    template<typename T>
+    double EvaluationCache<T>::GetHitRate()
+    {
+        unsigned long lookups = _hits + _misses;
+        if (lookups == 0)
+        {
+            return 0.0;
+        }
+        return (double)_hits / (double)lookups;
+    }
+}
+
+#endif
@@ -0,0 +1,273 @@
+#ifndef __FINITEDIFFERENCEJACOBIAN_H_INCLUDED__
+#define __FINITEDIFFERENCEJACOBIAN_H_INCLUDED__
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "TypeDefs.h"
+
+namespace APPRSDK
+{
+    enum FiniteDifferenceScheme {ForwardDifference, CentralDifference};
+
+    /*! \brief FiniteDifferenceJacobian
+    *
+    * Approximates the Jacobian of a residual vector by finite differences, evaluating the
+    * perturbed points concurrently. The objective is cloned into one context per thread
+    * (Initialize), so the contexts can regenerate their function systems independently.
+    * Every context but the first is bound to a worker thread that lives as long as the
+    * contexts, so Compute only wakes the workers instead of starting threads (it is called
+    * on every evaluation of the objective).
+    * The objective has to provide the following methods:
+    * Objective* Clone() - returns an independent copy owned by the caller (or 0)
+    * void EvaluateResidual(const ERowVecRef<T>& position, ERowVec<T>& residual)
+    *
+    * Forward differences need p, central differences 2p evaluations for p parameters.
+    * The step of the jth parameter is h_j = c max(|x_j|, 1) with c = sqrt(eps) for forward
+    * and c = cbrt(eps) for central differences (eps is the machine epsilon of T), rounded
+    * so that x_j + h_j - x_j is exactly h_j.
+    */
+    template<typename T, typename Objective>
+    class FiniteDifferenceJacobian
+    {
+        protected:
+            std::vector<Objective*> _contexts;
+            FiniteDifferenceScheme _scheme;
+            unsigned int _numberOfThreads;
+
+            // The workers and the points of the current Compute call, guarded by _mutex
+            std::vector<std::thread> _workers;
+            std::mutex _mutex;
+            std::condition_variable _start;
+            std::condition_variable _done;
+            unsigned long _generation;
+            unsigned int _activeContexts;
+            unsigned int _pending;
+            bool _stopping;
+            const ERowVec<T>* _position;
+            const ERowVec<T>* _steps;
+            std::vector<ERowVec<T> >* _residuals;
+
+            /*! \brief work
+            *
+            * The loop of the worker bound to context t: evaluates its share of the points of
+            * every Compute call that needs the context, until the contexts are cleared.
+            */
+            void work(unsigned int t)
+            {
+                unsigned long generation = 0;
+                std::unique_lock<std::mutex> lock(_mutex);
+                while (true)
+                {
+                    while (!_stopping && (_generation == generation || t >= _activeContexts))
+                    {
+                        _start.wait(lock);
+                    }
+                    if (_stopping)
+                    {
+                        return;
+                    }
+
+                    generation = _generation;
+                    unsigned int stride = _activeContexts;
+                    lock.unlock();
+                    evaluateColumns(_contexts[t], t, stride, *_position, *_steps, *_residuals);
+                    lock.lock();
+                    if (--_pending == 0)
+                    {
+                        _done.notify_one();
+                    }
+                }
+            }
+
+            void clearContexts()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _stopping = true;
+                }
+                _start.notify_all();
+                for (unsigned int t = 0; t < _workers.size(); ++t)
+                {
+                    _workers[t].join();
+                }
+                _workers.clear();
+                _stopping = false;
+
+                for (unsigned int i = 0; i < _contexts.size(); ++i)
+                {
+                    delete _contexts[i];
+                }
+                _contexts.clear();
+            }
+
+            /*! \brief evaluateColumns
+            *
+            * Evaluates the perturbed points first, first + stride, ... with the given context.
+            * Point k < p is x + h_k e_k, point p + k (central differences) is x - h_k e_k.
+            */
+            void evaluateColumns(Objective* context, unsigned int first, unsigned int stride, const ERowVec<T>& x,
+                                 const ERowVec<T>& steps, std::vector<ERowVec<T> >& residuals)
+            {
+                const unsigned int p = x.cols();
+                ERowVec<T> perturbed;
+
+                for (unsigned int k = first; k < residuals.size(); k += stride)
+                {
+                    perturbed = x;
+                    if (k < p)
+                    {
+                        perturbed(k) += steps(k);
+                    }
+                    else
+                    {
+                        perturbed(k - p) -= steps(k - p);
+                    }
+                    context->EvaluateResidual(perturbed, residuals[k]);
+                }
+            }
+
+        public:
+            FiniteDifferenceJacobian(FiniteDifferenceScheme scheme = ForwardDifference, unsigned int numberOfThreads = 0)
+                : _generation(0), _activeContexts(0), _pending(0), _stopping(false), _position(0), _steps(0), _residuals(0)
+            {
+                _scheme = scheme;
+                _numberOfThreads = (numberOfThreads == 0) ? std::thread::hardware_concurrency() : numberOfThreads;
+                if (_numberOfThreads == 0)
+                {
+                    _numberOfThreads = 1;
+                }
+            }
+
+            ~FiniteDifferenceJacobian()
+            {
+                clearContexts();
+            }
+
+            void SetScheme(FiniteDifferenceScheme scheme)
+            {
+                _scheme = scheme;
+            }
+
+            FiniteDifferenceScheme GetScheme()
+            {
+                return _scheme;
+            }
+
+            unsigned int GetNumberOfContexts()
+            {
+                return _contexts.size();
+            }
+
+            /*! \brief Clear
+            *
+            * Drops the contexts, i.e. after the prototype changed.
+            */
+            void Clear()
+            {
+                clearContexts();
+            }
+
+            /*! \brief Initialize
+            *
+            * Clones the prototype into the per-thread contexts and starts their workers.
+            * Has to be called again
+            * whenever the prototype changes (i.e. new signal or weights). Returns false if
+            * the prototype can not be cloned; then no context is kept and Compute returns
+            * an empty matrix.
+            */
+            bool Initialize(Objective& prototype)
+            {
+                clearContexts();
+                for (unsigned int i = 0; i < _numberOfThreads; ++i)
+                {
+                    Objective* context = prototype.Clone();
+                    if (context == 0)
+                    {
+                        clearContexts();
+                        return false;
+                    }
+                    _contexts.push_back(context);
+                }
+                for (unsigned int t = 1; t < _contexts.size(); ++t)
+                {
+                    _workers.push_back(std::thread(&FiniteDifferenceJacobian<T, Objective>::work, this, t));
+                }
+                return true;
+            }
+
+            /*! \brief Compute
+            *
+            * Computes the Jacobian of the residual at x. residual is the residual at x,
+            * it is only used by forward differences. The rows of the Jacobian belong to
+            * the residual entries, the columns to the parameters.
+            */
+            void Compute(const ERowVecRef<T>& x, const ERowVec<T>& residual, EMatrix<T>& jacobian)
+            {
+                const unsigned int p = x.cols();
+                const unsigned int contexts = _contexts.size();
+
+                if (contexts == 0)
+                {
+                    jacobian.resize(0, 0);
+                    return;
+                }
+
+                const T c = (_scheme == ForwardDifference) ? sqrt(std::numeric_limits<T>::epsilon()) : cbrt(std::numeric_limits<T>::epsilon());
+                ERowVec<T> position = x;
+                ERowVec<T> steps(p);
+                for (unsigned int k = 0; k < p; ++k)
+                {
+                    volatile T shifted = position(k) + c * std::max((T)std::abs(position(k)), (T)1.0);
+                    steps(k) = shifted - position(k);
+                }
+
+                std::vector<ERowVec<T> > residuals((_scheme == ForwardDifference) ? p : 2 * p);
+                const unsigned int active = std::min<unsigned int>(contexts, residuals.size());
+
+                if (active > 1)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _position = &position;
+                        _steps = &steps;
+                        _residuals = &residuals;
+                        _activeContexts = active;
+                        _pending = active - 1;
+                        _generation++;
+                    }
+                    _start.notify_all();
+                }
+                evaluateColumns(_contexts[0], 0, active, position, steps, residuals);
+
+                if (active > 1)
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    while (_pending != 0)
+                    {
+                        _done.wait(lock);
+                    }
+                    _activeContexts = 0;
+                }
+
+                jacobian.resize(residuals[0].cols(), p);
+                for (unsigned int k = 0; k < p; ++k)
+                {
+                    if (_scheme == ForwardDifference)
+                    {
+                        jacobian.col(k) = ((residuals[k] - residual) / steps(k)).transpose();
+                    }
+                    else
+                    {
+                        jacobian.col(k) = ((residuals[k] - residuals[p + k]) / (2 * steps(k))).transpose();
+                    }
+                }
+            }
+    };
+}
+
+#endif
@@ -29,11 +29,20 @@ namespace APPRSDK
 
         public:
             FunctionSystemDerivative(unsigned int numberOfValues, unsigned int degree);
-            ~FunctionSystemDerivative();
+            virtual ~FunctionSystemDerivative();
             
             Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> GetDFunctionSystem();
             Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> GetPartialDerivativesFunctionSystem();
             Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> GetIndex();
+
+            /*! \brief Clone()
+            *   Returns an independent copy of the function system (owned by the caller),
+            *   or 0 if the function system can not be copied.
+            */
+            virtual FunctionSystemDerivative<T>* Clone()
+            {
+                return 0;
+            }
     };
 
     /*! \brief Constructor
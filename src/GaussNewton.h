@@ -0,0 +1,180 @@
+#ifndef __GAUSSNEWTON_H_INCLUDED__
+#define __GAUSSNEWTON_H_INCLUDED__
+
+#include <Eigen/QR>
+#include "ApproxStrategyBase.h"
+
+namespace APPRSDK
+{
+    /*! \brief Gauss-Newton
+    *
+    * This class implements the IApproxStrategy interface with the Gauss-Newton method.
+    * The objective has to provide the residual (GetResidual) and its Jacobian
+    * (GetJacobian) of the last evaluated point, as VariableProjection does. The error
+    * is the norm of the residual.
+    *
+    * Steps are taken undamped as long as they decrease the error. When a step is
+    * rejected the method falls back to Levenberg-Marquardt damping:
+    * (J^T J + mu diag(J^T J)) d = -J^T r, mu is increased until a step is accepted,
+    * and decreased (down to a pure Gauss-Newton step again) after successful steps.
+    * Trial points are projected into the boundaries, if they were set.
+    */
+    template<typename T, typename ToBeMinimizedClass>
+    class GaussNewton : public ApproxStrategyBase<T, ToBeMinimizedClass>
+    {
+        protected:
+            T _stepTolerance;
+            T _initialDamping;
+
+            T _damping;
+            EColVec<T> _residual;
+            EMatrix<T> _jacobian;
+
+            /*! \brief step
+            *
+            * Solves the (damped) Gauss-Newton system for the given residual and Jacobian.
+            * A damping of 0 gives the least squares solution of J d = -r.
+            */
+            EColVec<T> step(const EColVec<T>& r, const EMatrix<T>& J, T damping)
+            {
+                if (damping == 0)
+                {
+                    return J.colPivHouseholderQr().solve(-r);
+                }
+
+                EMatrix<T> JtJ = J.transpose() * J;
+                EColVec<T> diag = JtJ.diagonal().cwiseMax((T)1e-12);
+                JtJ.diagonal() += damping * diag;
+                return JtJ.ldlt().solve(-(J.transpose() * r));
+            }
+
+        public:
+            GaussNewton() : _stepTolerance((T)1e-8), _initialDamping((T)1e-3), _damping(0)
+            {
+
+            }
+
+            /*! \brief GetState
+            *
+            * Exports the position, its error, the damping and the linearization.
+            */
+            OptimizerState<T> GetState()
+            {
+                OptimizerState<T> ret = ApproxStrategyBase<T, ToBeMinimizedClass>::GetState();
+                ret.strategy = "GN";
+                ret.damping = _damping;
+                ret.residual = _residual.transpose();
+                ret.jacobian = _jacobian;
+                return ret;
+            }
+
+            /*! \brief SetStepTolerance
+            *
+            * The iteration stops when the relative length of the accepted step
+            * falls below the given value.
+            */
+            void SetStepTolerance(T tolerance)
+            {
+                _stepTolerance = tolerance;
+            }
+
+            /*! \brief SetInitialDamping
+            *
+            * Sets the damping used after the first rejected Gauss-Newton step.
+            */
+            void SetInitialDamping(T damping)
+            {
+                _initialDamping = damping;
+            }
+
+            void Optimize(T maxError, unsigned int maxIterations, EMatrix<T> inputParameters, ToBeMinimizedClass minObjPtr)
+            {
+                this->_maxIterations = maxIterations;
+                this->_currentIteration = 0;
+                this->_maxError = maxError;
+                this->_minObjPtr = minObjPtr;
+                this->_budget.Start();
+
+                OptimizerState<T> state;
+                if (this->takeResumeState("GN", inputParameters.cols(), state))
+                {
+                    this->_currentPosition = state.points.row(0);
+                    _damping = state.damping;
+                }
+                else
+                {
+                    this->_currentPosition = inputParameters.row(0);
+                    _damping = 0;
+                }
+                this->projectToBoundaries(this->_currentPosition);
+
+                if (!state.IsEmpty() && this->isReusable(state.values(0)) && state.jacobian.rows() == state.residual.cols())
+                {
+                    this->_currentError = state.values(0);
+                    _residual = state.residual.transpose();
+                    _jacobian = state.jacobian;
+                }
+                else
+                {
+                    this->_currentError = this->evaluate(this->_currentPosition);
+                    _residual = this->_minObjPtr->GetResidual().transpose();
+                    _jacobian = this->_minObjPtr->GetJacobian();
+                }
+
+                StopReason reason = MaxIterationsReached;
+
+                while (this->_currentIteration < this->_maxIterations && !this->_budget.IsExhausted())
+                {
+                    if (this->_currentError <= this->_maxError)
+                    {
+                        reason = MaxErrorReached;
+                        break;
+                    }
+
+                    this->_currentIteration++;
+
+                    ERowVec<T> trial = this->_currentPosition + step(_residual, _jacobian, _damping).transpose();
+                    this->projectToBoundaries(trial);
+                    T trialError = this->evaluate(trial);
+
+                    if (trialError < this->_currentError)
+                    {
+                        T stepLength = (trial - this->_currentPosition).norm();
+
+                        this->_currentPosition = trial;
+                        this->_currentError = trialError;
+                        _residual = this->_minObjPtr->GetResidual().transpose();
+                        _jacobian = this->_minObjPtr->GetJacobian();
+
+                        _damping = (_damping / 10 < _initialDamping / 1000) ? 0 : _damping / 10;
+
+                        if (stepLength <= _stepTolerance * (this->_currentPosition.norm() + _stepTolerance))
+                        {
+                            reason = Converged;
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        // Rejected step: fall back to (stronger) damping
+                        _damping = (_damping == 0) ? _initialDamping : _damping * 10;
+
+                        if (_damping > (T)1e10)
+                        {
+                            reason = Converged;
+                            break;
+                        }
+                    }
+                }
+
+                if (this->_currentError <= this->_maxError)
+                {
+                    reason = MaxErrorReached;
+                }
+
+                this->finish(reason);
+            }
+    };
+}
+
+#endif
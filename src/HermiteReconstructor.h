@@ -0,0 +1,174 @@
+#ifndef __HERMITERECONSTRUCTOR_H_INCLUDED__
+#define __HERMITERECONSTRUCTOR_H_INCLUDED__
+
+#include <algorithm>
+#include <math.h>
+#include "TypeDefs.h"
+#include "CoefficientStore.h"
+#include "HermiteRecurrence.h"
+
+namespace APPRSDK
+{
+    /*! \brief HermiteReconstructor
+    *
+    * Rebuilds beats from stored Hermite models (coefficients, dilatation, translation)
+    * without an OrthonormalHermite per beat. All beats of a call share the length m and the
+    * number of functions n (models of lower degree have zero coefficients, as in the
+    * coefficient store), and each beat b is reconstructed as
+    * signal_b(i) = sum_k c_k(b) h_k(|d_b| (i - t_b)), i = 0 ... m-1,
+    * the same functions as OrthonormalHermite::ApplyNonLinearParameters([d_b, t_b]).
+    *
+    * Every beat has its own basis, so the product of bases and coefficients is a batch of
+    * matrix-vector products. The kernel fuses it with the three-term recurrence of the
+    * Hermite functions (see HermiteRecurrence): for each sample the recurrence runs on
+    * arrays holding all beats, which Eigen vectorizes, and the bases are never stored.
+    * Beats sharing the nonlinear parameters have a common basis, which is generated once
+    * and multiplied with the coefficients of all beats by one GEMM.
+    */
+    template<typename T>
+    class HermiteReconstructor
+    {
+        public:
+            typedef Eigen::Map<const EMatrix<T>, 0, Eigen::OuterStride<> > CoefficientMap;
+            typedef Eigen::Array<T, Eigen::Dynamic, 1> BeatArray;
+
+        protected:
+            unsigned int _length;
+            unsigned int _degrees;
+
+            // Sample i of all beats in column i
+            EArray<T> _values;
+            BeatArray _sum;
+            HermiteRecurrence<BeatArray> _recurrence;
+
+        public:
+            HermiteReconstructor(unsigned int length, unsigned int degrees) : _length(length), _degrees(degrees)
+            {
+
+            }
+
+            unsigned int GetLength()
+            {
+                return _length;
+            }
+
+            unsigned int GetDegrees()
+            {
+                return _degrees;
+            }
+
+            /*! \brief GetFunctionSystem
+            *
+            * The basis of one parameter set (m x n, the functions in the columns); the
+            * recurrence runs on all samples at once.
+            */
+            EMatrix<T> GetFunctionSystem(T dilatation, T translation)
+            {
+                EMatrix<T> ret(_length, _degrees);
+                _recurrence.Start((BeatArray::LinSpaced(_length, 0, (T)_length - 1) - translation) * fabs(dilatation));
+                for (unsigned int k = 0; k < _degrees; ++k)
+                {
+                    if (k > 0)
+                    {
+                        _recurrence.Next();
+                    }
+                    ret.col(k) = _recurrence.Value().matrix();
+                }
+                return ret;
+            }
+
+            /*! \brief Reconstruct
+            *
+            * Reconstructs B beats: coefficients is B x n (a row per beat, i.e. the linear
+            * parameters of a CoefficientBlock), dilatation and translation have B entries.
+            * signals is resized to m x B, a column per beat (zero if there are no coefficients).
+            */
+            template<typename Coefficients>
+            void Reconstruct(const Eigen::MatrixBase<Coefficients>& coefficients, const EColVec<T>& dilatation, const EColVec<T>& translation, EMatrix<T>& signals)
+            {
+                const long B = coefficients.rows();
+                const unsigned int n = (coefficients.cols() < _degrees) ? coefficients.cols() : _degrees;
+                if (n == 0)
+                {
+                    signals.setZero(_length, B);
+                    return;
+                }
+
+                BeatArray absDilatation = dilatation.array().abs();
+                _values.resize(B, _length);
+                for (unsigned int i = 0; i < _length; ++i)
+                {
+                    _recurrence.Start(absDilatation * ((T)i - translation.array()));
+                    _sum = coefficients.col(0).array() * _recurrence.Value();
+                    for (unsigned int k = 1; k < n; ++k)
+                    {
+                        _recurrence.Next();
+                        _sum += coefficients.col(k).array() * _recurrence.Value();
+                    }
+                    _values.col(i) = _sum;
+                }
+
+                signals = _values.matrix().transpose();
+            }
+
+            /*! \brief Reconstruct
+            *
+            * Reconstructs B beats sharing the nonlinear parameters with one GEMM.
+            */
+            template<typename Coefficients>
+            void Reconstruct(const Eigen::MatrixBase<Coefficients>& coefficients, T dilatation, T translation, EMatrix<T>& signals)
+            {
+                const unsigned int n = (coefficients.cols() < _degrees) ? coefficients.cols() : _degrees;
+                EMatrix<T> basis = GetFunctionSystem(dilatation, translation);
+                signals.noalias() = basis.leftCols(n) * coefficients.leftCols(n).transpose();
+            }
+
+            /*! \brief Reconstruct
+            *
+            * Reconstructs the beats of a block of a coefficient file; the nonlinear parameters
+            * are [dilatation, translation] as stored by VariableProjection with OrthonormalHermite.
+            * Returns false if the block has fewer than two nonlinear parameters.
+            */
+            bool Reconstruct(const CoefficientBlock<T>& block, EMatrix<T>& signals)
+            {
+                if (block.nonLinearParameters.cols() < 2)
+                {
+                    return false;
+                }
+                Reconstruct(block.linearParameters, EColVec<T>(block.nonLinearParameters.col(0)), EColVec<T>(block.nonLinearParameters.col(1)), signals);
+                return true;
+            }
+
+            /*! \brief Reconstruct
+            *
+            * Reconstructs count beats starting at firstBeat from a coefficient file (i.e. the
+            * beats visible while scrubbing through a record). signals is m x count.
+            */
+            bool Reconstruct(CoefficientReader<T>& reader, unsigned long firstBeat, unsigned long count, EMatrix<T>& signals)
+            {
+                if (reader.GetNumberOfBlocks() == 0 || reader.GetNonLinearCapacity() < 2)
+                {
+                    return false;
+                }
+                count = (firstBeat >= reader.GetNumberOfBeats()) ? 0 : std::min(count, reader.GetNumberOfBeats() - firstBeat);
+                signals.resize(_length, count);
+
+                CoefficientBlock<T> block;
+                EMatrix<T> part;
+                for (unsigned long done = 0; done < count; )
+                {
+                    reader.GetBlock((firstBeat + done) / reader.GetBlockSize(), block);
+                    unsigned long from = firstBeat + done - block.firstBeat;
+                    unsigned long length = std::min<unsigned long>(count - done, block.timestamps.size() - from);
+
+                    Reconstruct(block.linearParameters.middleRows(from, length), EColVec<T>(block.nonLinearParameters.col(0).segment(from, length)),
+                                EColVec<T>(block.nonLinearParameters.col(1).segment(from, length)), part);
+                    signals.middleCols(done, length) = part;
+                    done += length;
+                }
+                return true;
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef __HERMITERECURRENCE_H_INCLUDED__
+#define __HERMITERECURRENCE_H_INCLUDED__
+
+#include <math.h>
+#include "TypeDefs.h"
+
+namespace APPRSDK
+{
+    /*! \brief HermiteRecurrence
+    *
+    * The three-term recurrence of the orthonormal Hermite functions on an Eigen array of
+    * points (the lanes of OrthonormalHermiteBatch, the beats or the samples of
+    * HermiteReconstructor):
+    * h_0(x) = pi^(-1/4) e^(-x^2/2), h_1(x) = sqrt(2) x h_0(x),
+    * h_k(x) = sqrt(2/k) x h_(k-1)(x) - sqrt((k-1)/k) h_(k-2)(x)
+    *
+    * Start computes h_0, every Next the following degree; Value holds the current one. The
+    * arrays are reused, so nothing is allocated once their size is set.
+    */
+    template<typename ArrayType>
+    class HermiteRecurrence
+    {
+        public:
+            typedef typename ArrayType::Scalar T;
+
+        protected:
+            ArrayType _x;
+            ArrayType _previous;
+            ArrayType _current;
+            ArrayType _next;
+            unsigned int _degree;
+
+        public:
+            HermiteRecurrence() : _degree(0)
+            {
+
+            }
+
+            template<typename Derived>
+            void Start(const Eigen::ArrayBase<Derived>& x)
+            {
+                const T h0Norm = (T)(1.0 / sqrt(sqrt(4.0 * atan(1.0))));
+                _x = x;
+                _current = (_x * _x * (T)(-0.5)).exp() * h0Norm;
+                _previous.setZero(_x.rows(), _x.cols());
+                _degree = 0;
+            }
+
+            void Next()
+            {
+                const unsigned int k = ++_degree;
+                _next = (T)sqrt(2.0 / k) * _x * _current - (T)sqrt((k - 1.0) / k) * _previous;
+                _previous.swap(_current);
+                _current.swap(_next);
+            }
+
+            const ArrayType& Value()
+            {
+                return _current;
+            }
+
+            unsigned int GetDegree()
+            {
+                return _degree;
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef __HYBRIDSTRATEGY_H_INCLUDED__
+#define __HYBRIDSTRATEGY_H_INCLUDED__
+
+#include "NelderMead.h"
+#include "GaussNewton.h"
+
+namespace APPRSDK
+{
+    /*! \brief HybridStrategy
+    *
+    * Composite strategy: the Nelder-Mead simplex runs from the (possibly poor) starting
+    * points until it detects a basin, i.e. the simplex has contracted or the errors of
+    * its vertices are close (see NelderMead::SetSimplexTolerances). Then the Jacobian
+    * based GaussNewton strategy (which falls back to Levenberg-Marquardt damping) is
+    * seeded with the best vertex to reach the tolerance in a few steps.
+    * The number of evaluations spent by each phase is reported separately.
+    * Boundaries are passed to both phases. The budget limits the whole optimization: the
+    * simplex phase runs under it, and the local phase only gets the time and the
+    * evaluations that are left (it is skipped if nothing is left). The same holds for
+    * the iterations: both phases together run at most maxIterations.
+    */
+    template<typename T, typename ToBeMinimizedClass>
+    class HybridStrategy : public ApproxStrategyBase<T, ToBeMinimizedClass>
+    {
+        protected:
+            NelderMead<T, ToBeMinimizedClass> _simplexPhase;
+            GaussNewton<T, ToBeMinimizedClass> _localPhase;
+
+            unsigned int _simplexEvaluations;
+            unsigned int _localEvaluations;
+            bool _localPhaseUsed;
+
+        public:
+            HybridStrategy() : _simplexEvaluations(0), _localEvaluations(0), _localPhaseUsed(false)
+            {
+                _simplexPhase.SetSimplexTolerances((T)1e-3, (T)1e-2);
+            }
+
+            /*! \brief SetBasinTolerances
+            *
+            * Sets when the simplex phase hands over to the local phase:
+            * simplex size and relative error spread (see NelderMead::SetSimplexTolerances).
+            */
+            void SetBasinTolerances(T sizeTolerance, T spreadTolerance)
+            {
+                _simplexPhase.SetSimplexTolerances(sizeTolerance, spreadTolerance);
+            }
+
+            void SetBoundaries(ERowVec<T> lb, ERowVec<T> ub)
+            {
+                ApproxStrategyBase<T, ToBeMinimizedClass>::SetBoundaries(lb, ub);
+                _simplexPhase.SetBoundaries(lb, ub);
+                _localPhase.SetBoundaries(lb, ub);
+            }
+
+            void SetState(const OptimizerState<T>& state, bool reuseValues)
+            {
+                _simplexPhase.SetState(state, reuseValues);
+                _localPhase.SetState(state, reuseValues);
+            }
+
+            /*! \brief GetState
+            *
+            * Returns the state of the phase that ran last.
+            */
+            OptimizerState<T> GetState()
+            {
+                return _localPhaseUsed ? _localPhase.GetState() : _simplexPhase.GetState();
+            }
+
+            unsigned int GetNumberOfEvaluations()
+            {
+                return _simplexEvaluations + _localEvaluations;
+            }
+
+            unsigned int GetSimplexEvaluations()
+            {
+                return _simplexEvaluations;
+            }
+
+            unsigned int GetLocalEvaluations()
+            {
+                return _localEvaluations;
+            }
+
+            void Optimize(T maxError, unsigned int maxIterations, EMatrix<T> inputParameters, ToBeMinimizedClass minObjPtr)
+            {
+                this->_maxIterations = maxIterations;
+                this->_maxError = maxError;
+                this->_minObjPtr = minObjPtr;
+                _localPhaseUsed = false;
+                _localEvaluations = 0;
+                this->_budget.Start();
+
+                _simplexPhase.SetBudget(this->_budget);
+                _simplexPhase.Optimize(maxError, maxIterations, inputParameters, minObjPtr);
+                _simplexEvaluations = _simplexPhase.GetNumberOfEvaluations();
+                this->_budget.Finish();
+
+                this->_currentPosition = _simplexPhase.GetPosition();
+                this->_currentError = _simplexPhase.GetCurrentError();
+                this->_currentIteration = _simplexPhase.GetIterations();
+                this->_stopReason = _simplexPhase.GetStopReason();
+
+                // The local phase gets what is left of the budget (0 means no limit)
+                OptimizationBudget<T> localBudget = this->_budget;
+                double deadline = this->_budget.GetDeadline();
+                unsigned int maxEvaluations = this->_budget.GetMaxEvaluations();
+                if (deadline > 0)
+                {
+                    localBudget.SetDeadline(deadline - this->_budget.GetElapsedTime());
+                }
+                if (maxEvaluations > 0)
+                {
+                    localBudget.SetMaxEvaluations((_simplexEvaluations < maxEvaluations) ? maxEvaluations - _simplexEvaluations : 0);
+                }
+
+                unsigned int simplexIterations = _simplexPhase.GetIterations();
+                unsigned int localIterations = (simplexIterations < maxIterations) ? maxIterations - simplexIterations : 0;
+
+                bool budgetLeft = true;
+                if (localIterations == 0)
+                {
+                    budgetLeft = false;
+                    this->_stopReason = MaxIterationsReached;
+                }
+                else if (deadline > 0 && localBudget.GetDeadline() <= 0)
+                {
+                    budgetLeft = false;
+                    this->_stopReason = DeadlineReached;
+                }
+                else if (maxEvaluations > 0 && localBudget.GetMaxEvaluations() == 0)
+                {
+                    budgetLeft = false;
+                    this->_stopReason = MaxEvaluationsReached;
+                }
+
+                // Switch to the local phase once the simplex found a basin (or ran out of iterations)
+                if (budgetLeft && (this->_stopReason == Converged || this->_stopReason == MaxIterationsReached))
+                {
+                    _localPhaseUsed = true;
+                    _localPhase.SetBudget(localBudget);
+                    _localPhase.Optimize(maxError, localIterations, EMatrix<T>(this->_currentPosition), minObjPtr);
+                    _localEvaluations = _localPhase.GetNumberOfEvaluations();
+                    this->_currentIteration += _localPhase.GetIterations();
+
+                    // The stop reason is the one of the phase whose point is returned
+                    if (_localPhase.GetCurrentError() <= this->_currentError)
+                    {
+                        this->_currentPosition = _localPhase.GetPosition();
+                        this->_currentError = _localPhase.GetCurrentError();
+                        this->_stopReason = _localPhase.GetStopReason();
+                    }
+                }
+                this->_budget.Finish();
+            }
+    };
+}
+
+#endif
@@ -2,10 +2,12 @@
 #define __IAPPROXSTRATEGY_H_INCLUDED__
 
 #include "TypeDefs.h"
+#include "OptimizationBudget.h"
+#include "OptimizerState.h"
 
 namespace APPRSDK
 {
-    enum AvailableOptimizers {LM, NM};
+    enum AvailableOptimizers {LM, NM, GN, DL, LBFGS, HYBRID};
 
     template<typename T, typename ToBeMinimizedClass>
     class IApproxStrategy
@@ -21,6 +23,12 @@ namespace APPRSDK
 			virtual ERowVec<T> GetPosition() = 0;
             virtual void SetBoundaries(ERowVec<T> lb, ERowVec<T> ub) = 0;
             virtual void HasJacobianInfo() = 0;
+            virtual void SetBudget(OptimizationBudget<T> budget) = 0;
+            virtual StopReason GetStopReason() = 0;
+            virtual double GetElapsedTime() = 0;
+            virtual unsigned int GetNumberOfEvaluations() = 0;
+            virtual OptimizerState<T> GetState() = 0;
+            virtual void SetState(const OptimizerState<T>& state, bool reuseValues) = 0;
     };
 }
 
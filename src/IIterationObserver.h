@@ -0,0 +1,98 @@
+#ifndef __IITERATIONOBSERVER_H_INCLUDED__
+#define __IITERATIONOBSERVER_H_INCLUDED__
+
+#include "TypeDefs.h"
+
+namespace APPRSDK
+{
+    /*! \brief Levels of detail an observer asks for.
+    *
+    * ObserveNothing: the observer is not called at all.
+    * ObserveErrors: the iteration number and the error are valid.
+    * ObserveParameters: the parameters are valid as well.
+    * ObserveTiming: the wall-clock time of the evaluation is measured as well (0 otherwise).
+    */
+    enum ObserverLevel {ObserveNothing, ObserveErrors, ObserveParameters, ObserveTiming};
+
+    /*! \brief IIterationObserver
+    *
+    * Callback interface of the objective: OnEvaluation is called after every
+    * evaluation with the iteration (evaluation) number, the nonlinear parameters,
+    * the error and the evaluation time. The objective queries GetLevel before the
+    * evaluation and only gathers what the observer asked for.
+    */
+    template<typename T>
+    class IIterationObserver
+    {
+        public:
+            virtual ~IIterationObserver() {}
+
+            virtual ObserverLevel GetLevel() = 0;
+            virtual void OnEvaluation(unsigned int iteration, const ERowVecRef<T>& parameters, T error, double seconds) = 0;
+    };
+
+    /*! \brief NoObserverPolicy
+    *
+    * Default observer policy of VariableProjection: nothing is observed. The level is a
+    * constant, so the reporting in Evaluate is removed by the compiler.
+    */
+    template<typename T>
+    class NoObserverPolicy
+    {
+        protected:
+            ObserverLevel getObserverLevel()
+            {
+                return ObserveNothing;
+            }
+
+            void notifyObserver(unsigned int iteration, const ERowVecRef<T>& parameters, T error, double seconds)
+            {
+
+            }
+    };
+
+    /*! \brief RuntimeObserverPolicy
+    *
+    * Observer policy of VariableProjection with an observer set at runtime (SetObserver).
+    * Every evaluation costs a null test and, with an observer, a virtual GetLevel call.
+    */
+    template<typename T>
+    class RuntimeObserverPolicy
+    {
+        protected:
+            IIterationObserver<T>* _observer;
+
+            ObserverLevel getObserverLevel()
+            {
+                return (_observer != 0) ? _observer->GetLevel() : ObserveNothing;
+            }
+
+            void notifyObserver(unsigned int iteration, const ERowVecRef<T>& parameters, T error, double seconds)
+            {
+                _observer->OnEvaluation(iteration, parameters, error, seconds);
+            }
+
+        public:
+            RuntimeObserverPolicy() : _observer(0)
+            {
+
+            }
+
+            /*! \brief SetObserver
+            *
+            * Sets the observer called after every evaluation (see IterationObservers.h),
+            * 0 (default) turns the reporting off. The observer is not owned.
+            */
+            void SetObserver(IIterationObserver<T>* observer)
+            {
+                _observer = observer;
+            }
+
+            IIterationObserver<T>* GetObserver()
+            {
+                return _observer;
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef __IRECORDREADER_H_INCLUDED__
+#define __IRECORDREADER_H_INCLUDED__
+
+#include <string>
+#include <stdint.h>
+#include "TypeDefs.h"
+
+namespace APPRSDK
+{
+    /*! \brief IRecordReader
+    *
+    * Interface of the streaming readers of multi-channel records (WfdbReader, EdfReader).
+    * The samples are read block by block into a channels x length matrix in physical
+    * units, stored row-major, so the samples of one channel are contiguous and a row can
+    * be handed to the approximator as it is (i.e. VariableProjection::SetSignal(block.row(c))).
+    * The memory used does not depend on the length of the record.
+    */
+    template<typename T>
+    class IRecordReader
+    {
+        public:
+            virtual ~IRecordReader() {}
+
+            virtual unsigned int GetNumberOfChannels() = 0;
+            virtual std::string GetChannelName(unsigned int channel) = 0;
+            virtual double GetSamplingFrequency() = 0;
+
+            /*! \brief GetLength
+            *
+            * Number of samples per channel (0 if the record does not tell).
+            */
+            virtual unsigned long GetLength() = 0;
+
+            /*! \brief ReadBlock
+            *
+            * Reads the next at most maxLength samples of every channel into block (resized to
+            * channels x read samples, which does not allocate if the block is large enough).
+            * Returns the number of samples read per channel, 0 at the end of the record.
+            */
+            virtual unsigned long ReadBlock(ERowMajorMatrix<T>& block, unsigned long maxLength) = 0;
+
+            /*! \brief Rewind
+            *
+            * Continues reading from the beginning of the record.
+            */
+            virtual bool Rewind() = 0;
+    };
+
+    /*! \brief littleEndianToHost
+    *
+    * Converts 16 bit samples read as little-endian bytes (WFDB format 16, EDF) to the
+    * byte order of the host; does nothing on little-endian hosts.
+    */
+    inline void littleEndianToHost(int16_t* samples, unsigned long count)
+    {
+        const uint16_t one = 1;
+        if (*reinterpret_cast<const unsigned char*>(&one) == 1)
+        {
+            return;
+        }
+        for (unsigned long i = 0; i < count; ++i)
+        {
+            const unsigned char* b = reinterpret_cast<const unsigned char*>(samples + i);
+            samples[i] = (int16_t)(uint16_t)(b[0] | (b[1] << 8));
+        }
+    }
+
+    /*! \brief SampleBlockIterator
+    *
+    * Input iterator over the sample blocks of a reader; the default constructed iterator
+    * is the end. The block is reused, so it is only valid until the iterator is advanced.
+    *
+    * for (SampleBlockIterator<double> block(&reader, 1024), end; block != end; ++block)
+    * {
+    *     approximator.SetSignal(block->row(0));
+    * }
+    */
+    template<typename T>
+    class SampleBlockIterator
+    {
+        protected:
+            IRecordReader<T>* _reader;
+            unsigned long _blockLength;
+            ERowMajorMatrix<T> _block;
+
+        public:
+            SampleBlockIterator() : _reader(0), _blockLength(0)
+            {
+
+            }
+
+            SampleBlockIterator(IRecordReader<T>* reader, unsigned long blockLength) : _reader(reader), _blockLength(blockLength)
+            {
+                ++(*this);
+            }
+
+            SampleBlockIterator& operator++()
+            {
+                if (_reader != 0 && _reader->ReadBlock(_block, _blockLength) == 0)
+                {
+                    _reader = 0;
+                }
+                return *this;
+            }
+
+            const ERowMajorMatrix<T>& operator*() const
+            {
+                return _block;
+            }
+
+            const ERowMajorMatrix<T>* operator->() const
+            {
+                return &_block;
+            }
+
+            bool operator==(const SampleBlockIterator& other) const
+            {
+                return _reader == other._reader;
+            }
+
+            bool operator!=(const SampleBlockIterator& other) const
+            {
+                return _reader != other._reader;
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,267 @@
+#ifndef __ITERATIONOBSERVERS_H_INCLUDED__
+#define __ITERATIONOBSERVERS_H_INCLUDED__
+
+#include <iostream>
+#include <limits>
+#include <vector>
+#include "IIterationObserver.h"
+
+namespace APPRSDK
+{
+    /*! \brief NullObserver
+    *
+    * Observes nothing. Its level is ObserveNothing, so the objective never calls it
+    * and does not measure time: the only cost is one branch per evaluation.
+    */
+    template<typename T>
+    class NullObserver : public IIterationObserver<T>
+    {
+        public:
+            ObserverLevel GetLevel()
+            {
+                return ObserveNothing;
+            }
+
+            void OnEvaluation(unsigned int iteration, const ERowVecRef<T>& parameters, T error, double seconds)
+            {
+
+            }
+    };
+
+    /*! \brief CountingObserver
+    *
+    * Counts the evaluations and keeps the best error and the iteration it was found in.
+    */
+    template<typename T>
+    class CountingObserver : public IIterationObserver<T>
+    {
+        protected:
+            unsigned long _evaluations;
+            T _bestError;
+            unsigned int _bestIteration;
+
+        public:
+            CountingObserver()
+            {
+                Reset();
+            }
+
+            ObserverLevel GetLevel()
+            {
+                return ObserveErrors;
+            }
+
+            void OnEvaluation(unsigned int iteration, const ERowVecRef<T>& parameters, T error, double seconds)
+            {
+                _evaluations++;
+                if (error < _bestError)
+                {
+                    _bestError = error;
+                    _bestIteration = iteration;
+                }
+            }
+
+            void Reset()
+            {
+                _evaluations = 0;
+                _bestError = std::numeric_limits<T>::max();
+                _bestIteration = 0;
+            }
+
+            unsigned long GetNumberOfEvaluations()
+            {
+                return _evaluations;
+            }
+
+            T GetBestError()
+            {
+                return _bestError;
+            }
+
+            unsigned int GetBestIteration()
+            {
+                return _bestIteration;
+            }
+    };
+
+    /*! \brief TimingObserver
+    *
+    * Collects the total, minimal, maximal and mean wall-clock time of the evaluations.
+    */
+    template<typename T>
+    class TimingObserver : public IIterationObserver<T>
+    {
+        protected:
+            unsigned long _evaluations;
+            double _total;
+            double _min;
+            double _max;
+
+        public:
+            TimingObserver()
+            {
+                Reset();
+            }
+
+            ObserverLevel GetLevel()
+            {
+                return ObserveTiming;
+            }
+
+            void OnEvaluation(unsigned int iteration, const ERowVecRef<T>& parameters, T error, double seconds)
+            {
+                _evaluations++;
+                _total += seconds;
+                _min = (seconds < _min) ? seconds : _min;
+                _max = (seconds > _max) ? seconds : _max;
+            }
+
+            void Reset()
+            {
+                _evaluations = 0;
+                _total = 0;
+                _min = std::numeric_limits<double>::max();
+                _max = 0;
+            }
+
+            unsigned long GetNumberOfEvaluations()
+            {
+                return _evaluations;
+            }
+
+            double GetTotalTime()
+            {
+                return _total;
+            }
+
+            double GetMinTime()
+            {
+                return (_evaluations == 0) ? 0 : _min;
+            }
+
+            double GetMaxTime()
+            {
+                return _max;
+            }
+
+            double GetMeanTime()
+            {
+                return (_evaluations == 0) ? 0 : _total / _evaluations;
+            }
+    };
+
+    /*! \brief TraceRecord
+    *
+    * One evaluation recorded by TraceObserver.
+    */
+    template<typename T>
+    struct TraceRecord
+    {
+        unsigned int iteration;
+        ERowVec<T> parameters;
+        T error;
+        double seconds;
+    };
+
+    /*! \brief TraceObserver
+    *
+    * Keeps the last evaluations in a ring buffer of fixed capacity. The records are
+    * allocated once, so tracing does not allocate in the optimization loop (as long as
+    * the number of parameters does not change).
+    */
+    template<typename T>
+    class TraceObserver : public IIterationObserver<T>
+    {
+        protected:
+            std::vector<TraceRecord<T> > _records;
+            unsigned int _next;
+            unsigned int _size;
+            ObserverLevel _level;
+
+        public:
+            TraceObserver(unsigned int capacity = 64, ObserverLevel level = ObserveTiming) : _records(capacity), _next(0), _size(0), _level(level)
+            {
+
+            }
+
+            ObserverLevel GetLevel()
+            {
+                return _records.empty() ? ObserveNothing : _level;
+            }
+
+            void OnEvaluation(unsigned int iteration, const ERowVecRef<T>& parameters, T error, double seconds)
+            {
+                TraceRecord<T>& record = _records[_next];
+                record.iteration = iteration;
+                if (_level >= ObserveParameters)
+                {
+                    record.parameters = parameters;
+                }
+                record.error = error;
+                record.seconds = seconds;
+
+                _next = (_next + 1) % _records.size();
+                _size = (_size < _records.size()) ? _size + 1 : _size;
+            }
+
+            void Clear()
+            {
+                _next = 0;
+                _size = 0;
+            }
+
+            unsigned int GetSize()
+            {
+                return _size;
+            }
+
+            /*! \brief GetRecord
+            *
+            * Returns the i-th kept record, 0 is the oldest one.
+            */
+            const TraceRecord<T>& GetRecord(unsigned int i)
+            {
+                return _records[(_next + _records.size() - _size + i) % _records.size()];
+            }
+
+            void Print(std::ostream& stream)
+            {
+                for (unsigned int i = 0; i < _size; ++i)
+                {
+                    const TraceRecord<T>& record = GetRecord(i);
+                    stream << record.iteration << "\t" << record.error << "\t" << record.seconds << "\t" << record.parameters << "\n";
+                }
+            }
+    };
+
+    /*! \brief ConsoleObserver
+    *
+    * Writes the position and the error of every evaluation to a stream (the output
+    * VariableProjection used to print), without flushing after each line.
+    */
+    template<typename T>
+    class ConsoleObserver : public IIterationObserver<T>
+    {
+        protected:
+            std::ostream& _stream;
+
+        public:
+            ConsoleObserver(std::ostream& stream = std::cout) : _stream(stream)
+            {
+
+            }
+
+            ObserverLevel GetLevel()
+            {
+                return ObserveParameters;
+            }
+
+            void OnEvaluation(unsigned int iteration, const ERowVecRef<T>& parameters, T error, double seconds)
+            {
+                _stream << "current position: " << parameters << "\n";
+                _stream << "current error: " << error << "\n";
+            }
+    };
+}
+
+#endif
@@ -16,6 +16,11 @@ namespace APPRSDK
         LM* p = (LM*)ptr;
         p->SetPosition(p->algArray2vec(x));
         fi[0] = (double)p->GetObjectVal();
+
+        if (p->IsBudgetExhausted())
+        {
+            p->RequestTermination();
+        }
     }
 
     template<typename T, typename LM>
@@ -46,8 +51,26 @@ namespace APPRSDK
 	class LevenbergMarquardt : public ApproxStrategyBase<T, ToBeMinimizedClass>
 	{
         protected:
+            alglib::minlmstate* _state;
 
         public:
+            LevenbergMarquardt() : _state(0)
+            {
+
+            }
+
+            /*! \brief RequestTermination
+            *
+            * Asks ALGLIB to stop the running optimization (i.e. when the budget is exhausted).
+            */
+            void RequestTermination()
+            {
+                if (_state != 0)
+                {
+                    alglib::minlmrequesttermination(*_state);
+                }
+            }
+
             alglib::real_1d_array vec2algArray(ERowVec<T> v)
             {
                 std::string s = "";
@@ -109,13 +132,28 @@ namespace APPRSDK
                 return ret;
             }
 
+            /*! \brief GetState
+            *
+            * The internal state of ALGLIB (i.e. the damping) is not accessible,
+            * only the position and its error are exported.
+            */
+            OptimizerState<T> GetState()
+            {
+                OptimizerState<T> ret = ApproxStrategyBase<T, ToBeMinimizedClass>::GetState();
+                ret.strategy = "LM";
+                return ret;
+            }
+
             void Optimize(T maxError, unsigned int maxIterations, EMatrix<T> inputParameters, ToBeMinimizedClass minObjPtr)
             {
+                OptimizerState<T> resumeState;
+
                 this->_maxIterations = maxIterations;
                 this->_currentIteration = 0;
                 this->_maxError = maxError;
-                this->_currentPosition = inputParameters.row(0);
+                this->_currentPosition = this->takeResumeState("LM", inputParameters.cols(), resumeState) ? ERowVec<T>(resumeState.points.row(0)) : ERowVec<T>(inputParameters.row(0));
                 this->_minObjPtr = minObjPtr;
+                this->_budget.Start();
 
                 this->HasJacobianInfo();
 
@@ -124,6 +162,7 @@ namespace APPRSDK
                 alglib::ae_int_t maxits = this->_maxIterations;
                 alglib::minlmstate state;
                 alglib::minlmreport rep;
+                _state = &state;
 
                 //if (!this->_isJacobiInfoAvailable)
                 if (true)
@@ -158,11 +197,13 @@ namespace APPRSDK
                 }
 
                 alglib::minlmresults(state, x, rep);
+                _state = 0;
 
                 //Set results
                 this->SetPosition(algArray2vec(x));
                 this->_currentError = this->GetObjectVal();
                 this->_currentIteration = (int)rep.iterationscount;
+                this->finish((rep.terminationtype == 5) ? MaxIterationsReached : Converged);
             }
     };
 }
@@ -0,0 +1,308 @@
+#ifndef __LIMITEDMEMORYBFGS_H_INCLUDED__
+#define __LIMITEDMEMORYBFGS_H_INCLUDED__
+
+#include <vector>
+#include "ApproxStrategyBase.h"
+
+namespace APPRSDK
+{
+    /*! \brief Limited memory BFGS
+    *
+    * This class implements the IApproxStrategy interface with the L-BFGS method.
+    * The minimized function is f = 1/2 |r|^2, its gradient J^T r is formed from the
+    * residual (GetResidual) and the Jacobian (GetJacobian) of the objective, so an
+    * iteration costs O(m p) for m samples and p nonlinear parameters (plus O(M p)
+    * for the M stored correction pairs), no linear system is solved.
+    *
+    * The step length is found by backtracking until the Armijo condition holds.
+    * If boundaries are set, the method becomes a projected L-BFGS: trial points are
+    * projected into the box, and the coordinates that sit on a bound with the
+    * gradient pointing outwards are kept fixed in the search direction.
+    */
+    template<typename T, typename ToBeMinimizedClass>
+    class LimitedMemoryBFGS : public ApproxStrategyBase<T, ToBeMinimizedClass>
+    {
+        protected:
+            unsigned int _memory;
+            T _gradientTolerance;
+            T _stepTolerance;
+
+            std::vector<EColVec<T> > _s;
+            std::vector<EColVec<T> > _y;
+            std::vector<T> _rho;
+
+            ERowVec<T> _residual;
+            EMatrix<T> _jacobian;
+
+            /*! \brief gradient
+            *
+            * Takes the residual and the Jacobian of the last evaluated point of the
+            * objective and returns the gradient J^T r.
+            */
+            EColVec<T> gradient()
+            {
+                _residual = this->_minObjPtr->GetResidual();
+                _jacobian = this->_minObjPtr->GetJacobian();
+                return _jacobian.transpose() * _residual.transpose();
+            }
+
+            void clearHistory()
+            {
+                _s.clear();
+                _y.clear();
+                _rho.clear();
+            }
+
+            void pushHistory(const EColVec<T>& step, const EColVec<T>& change)
+            {
+                if (_s.size() == _memory)
+                {
+                    _s.erase(_s.begin());
+                    _y.erase(_y.begin());
+                    _rho.erase(_rho.begin());
+                }
+                _s.push_back(step);
+                _y.push_back(change);
+                _rho.push_back((T)1.0 / step.dot(change));
+            }
+
+            /*! \brief fixedCoordinates
+            *
+            * Marks the coordinates that are on a bound while the gradient points out of the box.
+            */
+            std::vector<bool> fixedCoordinates(const ERowVec<T>& x, const EColVec<T>& g)
+            {
+                std::vector<bool> ret(x.size(), false);
+                if (!this->hasBoundaries(x.size()))
+                {
+                    return ret;
+                }
+
+                for (int i = 0; i < x.size(); ++i)
+                {
+                    ret[i] = (x(i) <= this->_lb(i) && g(i) > 0) || (x(i) >= this->_ub(i) && g(i) < 0);
+                }
+                return ret;
+            }
+
+            /*! \brief direction
+            *
+            * Two-loop recursion: returns -H g for the current inverse Hessian approximation H,
+            * with the fixed coordinates zeroed.
+            */
+            EColVec<T> direction(EColVec<T> g, const std::vector<bool>& fixed)
+            {
+                const int k = _s.size();
+                std::vector<T> alpha(k);
+
+                for (int i = k-1; i >= 0; --i)
+                {
+                    alpha[i] = _rho[i] * _s[i].dot(g);
+                    g -= alpha[i] * _y[i];
+                }
+
+                if (k > 0)
+                {
+                    g *= _s[k-1].dot(_y[k-1]) / _y[k-1].squaredNorm();
+                }
+
+                for (int i = 0; i < k; ++i)
+                {
+                    T beta = _rho[i] * _y[i].dot(g);
+                    g += (alpha[i] - beta) * _s[i];
+                }
+
+                for (unsigned int i = 0; i < fixed.size(); ++i)
+                {
+                    if (fixed[i])
+                    {
+                        g(i) = 0;
+                    }
+                }
+
+                return -g;
+            }
+
+        public:
+            LimitedMemoryBFGS() : _memory(5), _gradientTolerance((T)1e-10), _stepTolerance((T)1e-10)
+            {
+
+            }
+
+            /*! \brief GetState
+            *
+            * Exports the position, its error, the linearization and the correction pairs.
+            */
+            OptimizerState<T> GetState()
+            {
+                OptimizerState<T> ret = ApproxStrategyBase<T, ToBeMinimizedClass>::GetState();
+                ret.strategy = "LBFGS";
+                ret.residual = _residual;
+                ret.jacobian = _jacobian;
+
+                if (!_s.empty())
+                {
+                    ret.history.resize(2 * _s.size(), _s[0].rows());
+                    for (unsigned int i = 0; i < _s.size(); ++i)
+                    {
+                        ret.history.row(i) = _s[i].transpose();
+                        ret.history.row(_s.size() + i) = _y[i].transpose();
+                    }
+                }
+                return ret;
+            }
+
+            /*! \brief SetMemory
+            *
+            * Sets the number of stored correction pairs.
+            */
+            void SetMemory(unsigned int memory)
+            {
+                _memory = memory;
+            }
+
+            /*! \brief SetTolerances
+            *
+            * The iteration stops when the norm of the (projected) gradient or the
+            * relative length of the step falls below the given values.
+            */
+            void SetTolerances(T gradientTolerance, T stepTolerance)
+            {
+                _gradientTolerance = gradientTolerance;
+                _stepTolerance = stepTolerance;
+            }
+
+            void Optimize(T maxError, unsigned int maxIterations, EMatrix<T> inputParameters, ToBeMinimizedClass minObjPtr)
+            {
+                this->_maxIterations = maxIterations;
+                this->_currentIteration = 0;
+                this->_maxError = maxError;
+                this->_minObjPtr = minObjPtr;
+                this->_budget.Start();
+                clearHistory();
+
+                // The correction pairs only depend on the curvature, they are kept for a warm start
+                OptimizerState<T> state;
+                if (this->takeResumeState("LBFGS", inputParameters.cols(), state))
+                {
+                    this->_currentPosition = state.points.row(0);
+                    for (int i = 0; i < state.history.rows() / 2; ++i)
+                    {
+                        pushHistory(state.history.row(i).transpose(), state.history.row(state.history.rows() / 2 + i).transpose());
+                    }
+                }
+                else
+                {
+                    this->_currentPosition = inputParameters.row(0);
+                }
+                this->projectToBoundaries(this->_currentPosition);
+
+                EColVec<T> g;
+                if (!state.IsEmpty() && this->isReusable(state.values(0)) && state.jacobian.rows() == state.residual.cols())
+                {
+                    this->_currentError = state.values(0);
+                    _residual = state.residual;
+                    _jacobian = state.jacobian;
+                    g = _jacobian.transpose() * _residual.transpose();
+                }
+                else
+                {
+                    this->_currentError = this->evaluate(this->_currentPosition);
+                    g = gradient();
+                }
+
+                StopReason reason = MaxIterationsReached;
+
+                while (this->_currentIteration < this->_maxIterations && !this->_budget.IsExhausted())
+                {
+                    if (this->_currentError <= this->_maxError)
+                    {
+                        reason = MaxErrorReached;
+                        break;
+                    }
+
+                    std::vector<bool> fixed = fixedCoordinates(this->_currentPosition, g);
+                    EColVec<T> projectedGradient = g;
+                    for (unsigned int i = 0; i < fixed.size(); ++i)
+                    {
+                        if (fixed[i])
+                        {
+                            projectedGradient(i) = 0;
+                        }
+                    }
+
+                    if (projectedGradient.norm() <= _gradientTolerance)
+                    {
+                        reason = Converged;
+                        break;
+                    }
+
+                    EColVec<T> d = direction(g, fixed);
+                    if (g.dot(d) >= 0)
+                    {
+                        // Not a descent direction, restart from steepest descent
+                        clearHistory();
+                        d = direction(g, fixed);
+                    }
+
+                    this->_currentIteration++;
+
+                    // Backtracking line search, the first step is scaled to unit length
+                    T f = this->_currentError * this->_currentError / 2;
+                    T alpha = _s.empty() ? (T)1.0 / d.norm() : (T)1.0;
+                    ERowVec<T> trial;
+                    T trialError = 0;
+                    bool accepted = false;
+
+                    while (alpha > std::numeric_limits<T>::epsilon() && !this->_budget.IsExhausted())
+                    {
+                        trial = this->_currentPosition + alpha * d.transpose();
+                        this->projectToBoundaries(trial);
+                        trialError = this->evaluate(trial);
+
+                        if (trialError * trialError / 2 <= f + (T)1e-4 * g.dot((trial - this->_currentPosition).transpose()))
+                        {
+                            accepted = true;
+                            break;
+                        }
+                        alpha /= 2;
+                    }
+
+                    if (!accepted)
+                    {
+                        reason = Converged;
+                        break;
+                    }
+
+                    EColVec<T> step = (trial - this->_currentPosition).transpose();
+                    EColVec<T> newGradient = gradient();
+                    EColVec<T> change = newGradient - g;
+
+                    this->_currentPosition = trial;
+                    this->_currentError = trialError;
+                    g = newGradient;
+
+                    T curvature = step.dot(change);
+                    if (curvature > std::numeric_limits<T>::epsilon() * change.squaredNorm())
+                    {
+                        pushHistory(step, change);
+                    }
+
+                    if (step.norm() <= _stepTolerance * (this->_currentPosition.norm() + _stepTolerance))
+                    {
+                        reason = Converged;
+                        break;
+                    }
+                }
+
+                if (this->_currentError <= this->_maxError)
+                {
+                    reason = MaxErrorReached;
+                }
+
+                this->finish(reason);
+            }
+    };
+}
+
+#endif
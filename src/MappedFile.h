@@ -0,0 +1,100 @@
+#ifndef __MAPPEDFILE_H_INCLUDED__
+#define __MAPPEDFILE_H_INCLUDED__
+
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace APPRSDK
+{
+    /*! \brief MappedFile
+    *
+    * Read-only memory mapping of a whole file. The pages are loaded by the kernel on
+    * demand, so the file is neither read nor copied up front. The mapping is released
+    * by Close or the destructor, views into it (i.e. Eigen::Map) are invalid afterwards.
+    * POSIX only (mmap).
+    */
+    class MappedFile
+    {
+        protected:
+            const char* _data;
+            size_t _size;
+
+            MappedFile(const MappedFile&);
+            MappedFile& operator=(const MappedFile&);
+
+        public:
+            MappedFile() : _data(0), _size(0)
+            {
+
+            }
+
+            ~MappedFile()
+            {
+                Close();
+            }
+
+            /*! \brief Open
+            *
+            * Maps the file. Returns false if it cannot be opened or mapped. An empty file
+            * is opened with no data.
+            */
+            bool Open(const std::string& filename)
+            {
+                Close();
+
+                int file = open(filename.c_str(), O_RDONLY);
+                if (file < 0)
+                {
+                    return false;
+                }
+
+                struct stat status;
+                bool ok = fstat(file, &status) == 0;
+                if (ok && status.st_size > 0)
+                {
+                    void* data = mmap(0, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+                    ok = data != MAP_FAILED;
+                    if (ok)
+                    {
+                        // The file is read front to back
+                        madvise(data, status.st_size, MADV_SEQUENTIAL);
+                        _data = static_cast<const char*>(data);
+                        _size = status.st_size;
+                    }
+                }
+
+                close(file);
+                return ok;
+            }
+
+            void Close()
+            {
+                if (_data != 0)
+                {
+                    munmap(const_cast<char*>(_data), _size);
+                    _data = 0;
+                    _size = 0;
+                }
+            }
+
+            bool IsOpen()
+            {
+                return _data != 0;
+            }
+
+            const char* GetData()
+            {
+                return _data;
+            }
+
+            size_t GetSize()
+            {
+                return _size;
+            }
+    };
+}
+
+#endif
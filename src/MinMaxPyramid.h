@@ -0,0 +1,204 @@
+#ifndef __MINMAXPYRAMID_H_INCLUDED__
+#define __MINMAXPYRAMID_H_INCLUDED__
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+#include "TypeDefs.h"
+#include "matplotlibcpp.h"
+
+namespace APPRSDK
+{
+    /*! \brief MinMaxPyramid
+    *
+    * Level of detail for plotting long records. Only a few thousand pixel columns are
+    * visible, so instead of all samples the envelope of the visible range is plotted:
+    * the minimum and the maximum of the samples falling into each pixel column (two
+    * points per column). The plot looks the same, but its cost depends on the number of
+    * columns instead of the length of the record.
+    *
+    * The envelope is served from a pyramid built once by Build: level k holds the minima
+    * and maxima of consecutive blocks of factor^k samples. The extremes of a column are
+    * exact: the column is covered by whole blocks of the coarsest possible level, plus
+    * less than factor blocks per finer level at its ends. So a query (zoom or pan) costs
+    * O(columns * factor * levels), independent of the record length. All reductions run on
+    * contiguous Eigen segments, which Eigen vectorizes (SIMD).
+    *
+    * The envelope is kept in the pyramid and plotted without copying (see the Eigen
+    * overloads of matplotlibcpp), so it stays valid until the next envelope is computed.
+    */
+    template<typename T>
+    class MinMaxPyramid
+    {
+        protected:
+            unsigned int _factor;
+            ERowVec<T> _signal;
+            std::vector<ERowVec<T> > _min;
+            std::vector<ERowVec<T> > _max;
+            std::vector<unsigned long> _blockSize;
+
+            ERowVec<T> _x;
+            ERowVec<T> _y;
+
+            /*! \brief reduce
+            *
+            * Min / max of consecutive groups of factor values: the values are viewed as a
+            * factor x n column-major matrix, whose columns are reduced.
+            */
+            static void reduce(const ERowVec<T>& min, const ERowVec<T>& max, unsigned int factor, ERowVec<T>& coarseMin, ERowVec<T>& coarseMax)
+            {
+                long n = min.cols() / factor;
+                coarseMin = Eigen::Map<const EMatrix<T> >(min.data(), factor, n).colwise().minCoeff();
+                coarseMax = Eigen::Map<const EMatrix<T> >(max.data(), factor, n).colwise().maxCoeff();
+            }
+
+            /*! \brief minMax
+            *
+            * Exact min / max of the samples [from, to): the unaligned ends are reduced on
+            * the finer levels (less than factor values per level and end), the aligned
+            * middle on the coarsest level that covers it.
+            */
+            void minMax(unsigned long from, unsigned long to, T& min, T& max)
+            {
+                min = std::numeric_limits<T>::max();
+                max = -std::numeric_limits<T>::max();
+
+                unsigned long blockSize = 1;
+                for (unsigned int level = 0; from < to; ++level)
+                {
+                    const ERowVec<T>& levelMin = (level == 0) ? _signal : _min[level - 1];
+                    const ERowVec<T>& levelMax = (level == 0) ? _signal : _max[level - 1];
+                    unsigned long next = blockSize * _factor;
+                    unsigned long alignedFrom = (from + next - 1) / next * next;
+                    unsigned long alignedTo = to / next * next;
+
+                    if (level == _min.size() || alignedFrom >= alignedTo)
+                    {
+                        min = std::min(min, levelMin.segment(from / blockSize, (to - from) / blockSize).minCoeff());
+                        max = std::max(max, levelMax.segment(from / blockSize, (to - from) / blockSize).maxCoeff());
+                        break;
+                    }
+
+                    if (from < alignedFrom)
+                    {
+                        min = std::min(min, levelMin.segment(from / blockSize, (alignedFrom - from) / blockSize).minCoeff());
+                        max = std::max(max, levelMax.segment(from / blockSize, (alignedFrom - from) / blockSize).maxCoeff());
+                    }
+                    if (alignedTo < to)
+                    {
+                        min = std::min(min, levelMin.segment(alignedTo / blockSize, (to - alignedTo) / blockSize).minCoeff());
+                        max = std::max(max, levelMax.segment(alignedTo / blockSize, (to - alignedTo) / blockSize).maxCoeff());
+                    }
+
+                    from = alignedFrom;
+                    to = alignedTo;
+                    blockSize = next;
+                }
+            }
+
+        public:
+            MinMaxPyramid(unsigned int factor = 4) : _factor(factor < 2 ? 2 : factor)
+            {
+
+            }
+
+            /*! \brief Build
+            *
+            * Copies the record and builds the levels of the pyramid (2/(factor-1) times
+            * the record length of additional memory).
+            */
+            void Build(const ERowVecRef<T>& signal)
+            {
+                _signal = signal;
+                _min.clear();
+                _max.clear();
+                _blockSize.clear();
+
+                // Level 0 is the record itself
+                unsigned long blockSize = 1;
+                while ((_min.empty() ? _signal.cols() : _min.back().cols()) >= _factor)
+                {
+                    ERowVec<T> coarseMin, coarseMax;
+                    reduce(_min.empty() ? _signal : _min.back(), _max.empty() ? _signal : _max.back(), _factor, coarseMin, coarseMax);
+                    _min.push_back(coarseMin);
+                    _max.push_back(coarseMax);
+
+                    blockSize *= _factor;
+                    _blockSize.push_back(blockSize);
+                }
+            }
+
+            unsigned long GetLength()
+            {
+                return _signal.cols();
+            }
+
+            unsigned int GetNumberOfLevels()
+            {
+                return _min.size() + 1;
+            }
+
+            /*! \brief Envelope
+            *
+            * Computes the envelope of the samples [begin, end) for the given number of
+            * columns into x (sample positions) and y (values). If there are fewer than two
+            * samples per column, the samples themselves are returned.
+            */
+            void Envelope(unsigned long begin, unsigned long end, unsigned int columns, ERowVec<T>& x, ERowVec<T>& y)
+            {
+                end = (end > (unsigned long)_signal.cols()) ? _signal.cols() : end;
+                if (end <= begin || columns == 0)
+                {
+                    x.resize(0);
+                    y.resize(0);
+                    return;
+                }
+
+                unsigned long length = end - begin;
+                if (length < 2 * (unsigned long)columns)
+                {
+                    x = ERowVec<T>::LinSpaced(length, begin, end - 1);
+                    y = _signal.segment(begin, length);
+                    return;
+                }
+
+                double samplesPerColumn = (double)length / columns;
+                x.resize(2 * columns);
+                y.resize(2 * columns);
+                unsigned long from = begin;
+                for (unsigned int c = 0; c < columns; ++c)
+                {
+                    unsigned long to = (c + 1 == columns) ? end : begin + (unsigned long)((c + 1) * samplesPerColumn);
+
+                    x(2 * c) = x(2 * c + 1) = (T)from;
+                    minMax(from, to, y(2 * c), y(2 * c + 1));
+                    from = to;
+                }
+            }
+
+            /*! \brief Plot
+            *
+            * Plots the envelope of [begin, end) with the given number of columns
+            * (i.e. the width of the axes in pixels).
+            */
+            bool Plot(unsigned long begin, unsigned long end, unsigned int columns, const std::string& format = "")
+            {
+                Envelope(begin, end, columns, _x, _y);
+                return matplotlibcpp::plot(_x, _y, format);
+            }
+
+            /*! \brief Update
+            *
+            * Replaces the data of a persistent line with the envelope of [begin, end),
+            * i.e. for zooming and panning in a live plot (see matplotlibcpp::Animation).
+            */
+            bool Update(matplotlibcpp::Plot& line, unsigned long begin, unsigned long end, unsigned int columns)
+            {
+                Envelope(begin, end, columns, _x, _y);
+                return line.update(_x, _y);
+            }
+    };
+}
+
+#endif
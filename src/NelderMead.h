@@ -3,6 +3,8 @@
 
 #include <iostream>
 #include <map>
+#include <iterator>
+#include <algorithm>
 #include "ApproxStrategyBase.h"
 #include "Coord.h"
 
@@ -12,20 +14,75 @@ namespace APPRSDK
 	 *
 	 * This class implements the IApproxStrategy interface with
 	 * the classical (non-complex based) Nelder-Mead algorithm.
+	 * If boundaries are set (SetBoundaries), every trial point is
+	 * projected into the box before it is evaluated, so the objective
+	 * is never called outside of the bounds.
+	 * The iteration can also stop when the simplex has contracted into a basin,
+	 * see SetSimplexTolerances.
 	 */
 	template<typename T, typename ToBeMinimizedClass>
 	class NelderMead : public ApproxStrategyBase<T, ToBeMinimizedClass>
 	{
 	    private:
 	        std::multimap<T, Coord<T>> population;
+	        T _sizeTolerance;
+	        T _spreadTolerance;
 
 	        std::vector<typename std::multimap<T, Coord<T> >::reverse_iterator> setPointers();
 	        void initalize(T maxError, unsigned int maxIterations, EMatrix<T> inputParameters, ToBeMinimizedClass costFun);
+	        bool isContracted();
 
 	    public:
+	        NelderMead() : _sizeTolerance(0), _spreadTolerance(0) {}
+
 	        void Optimize(T maxError, unsigned int maxIterations, EMatrix<T> inputParameters, ToBeMinimizedClass costFun);
+	        void SetSimplexTolerances(T sizeTolerance, T spreadTolerance);
+	        OptimizerState<T> GetState();
 	};
 
+	/*! \brief SetSimplexTolerances
+	 *
+	 * The iteration stops (Converged) when the largest coordinate distance of a vertex
+	 * from the best vertex falls below sizeTolerance, or when the spread of the errors
+	 * (worst - best) falls below spreadTolerance times the best error.
+	 * A tolerance of 0 (default) disables the given test.
+	 */
+	template<typename T, typename ToBeMinimizedClass>
+	void NelderMead<T, ToBeMinimizedClass>::SetSimplexTolerances(T sizeTolerance, T spreadTolerance)
+	{
+		_sizeTolerance = sizeTolerance;
+		_spreadTolerance = spreadTolerance;
+	}
+
+	/*! \brief isContracted
+	 *
+	 * Checks the simplex size and the error spread against the tolerances.
+	 */
+	template<typename T, typename ToBeMinimizedClass>
+	bool NelderMead<T, ToBeMinimizedClass>::isContracted()
+	{
+		const T best = population.begin()->first;
+		const T worst = population.rbegin()->first;
+
+		if (_spreadTolerance > 0 && worst - best <= _spreadTolerance * best)
+		{
+			return true;
+		}
+
+		if (_sizeTolerance > 0)
+		{
+			ERowVec<T> bestVertex = population.begin()->second.ToVector();
+			T size = 0;
+			for (typename std::multimap<T, Coord<T> >::iterator it = population.begin(); it != population.end(); ++it)
+			{
+				size = std::max(size, (it->second.ToVector() - bestVertex).cwiseAbs().maxCoeff());
+			}
+			return size <= _sizeTolerance;
+		}
+
+		return false;
+	}
+
 	template<typename T, typename ToBeMinimizedClass>
 	void NelderMead<T, ToBeMinimizedClass>::Optimize(T maxError, unsigned int maxIterations, EMatrix<T> inputParameters, ToBeMinimizedClass costFun)
 	{
@@ -36,13 +93,21 @@ namespace APPRSDK
 		
 		T dim = (T)(access_x[0]->second).size();
 
-		while ( access_x[2]->first > this->_maxError && this->_currentIteration < maxIterations ) {	
+		bool contracted = false;
+
+		while ( access_x[2]->first > this->_maxError && this->_currentIteration < maxIterations && !this->_budget.IsExhausted() ) {	
+			if ( isContracted() ) {
+				contracted = true;
+				break;
+			}
+
 			this->_currentIteration++;
 			
 			access_x = setPointers();		
 
 			Coord<T> x4 = access_x[0]->second + ((access_x[1]->second + access_x[2]->second)/dim - access_x[0]->second)*2.0;
-			T y4 = (*costFun)(x4.ToVector());
+			this->projectToBoundaries(x4);
+			T y4 = this->evaluate(x4.ToVector());
 
 			if ( access_x[2]->first <= y4 && access_x[1]->first >= y4) {
 				sort_pop.insert(std::pair<T, Coord<T>>(y4, x4));
@@ -54,8 +119,10 @@ namespace APPRSDK
 			}
 			else if ( y4 < access_x[2]->first ) {
 				Coord<T> x5 = access_x[0]->second +((access_x[1]->second + access_x[2]->second)/dim - access_x[0]->second)*2.5;
-				T y5 = (*costFun)(x5.ToVector());
-				if ( y4 < y5 ) {
+				this->projectToBoundaries(x5);
+				T y5 = this->evaluate(x5.ToVector());
+				// Keep the better of the expanded and the reflected point
+				if ( y5 < y4 ) {
 					sort_pop.insert(std::pair<T, Coord<T>>(y5, x5));
 					sort_pop.insert(std::pair<T, Coord<T>>(access_x[1]->first, access_x[1]->second));
 					sort_pop.insert(std::pair<T, Coord<T>>(access_x[2]->first, access_x[2]->second));
@@ -75,7 +142,8 @@ namespace APPRSDK
 			else if ( y4 >= access_x[1]->first ) {
 				if ( y4 < access_x[0]->first ) {
 					Coord<T> x6 = access_x[0]->second + ((access_x[1]->second + access_x[2]->second)/dim - access_x[0]->second)*1.5;
-					T y6 = (*costFun)(x6.ToVector());
+					this->projectToBoundaries(x6);
+					T y6 = this->evaluate(x6.ToVector());
 
 					if ( y6 <= y4 ) {
 						sort_pop.insert(std::pair<T, Coord<T>>(y6, x6));
@@ -90,8 +158,8 @@ namespace APPRSDK
 						Coord<T> x0 = (access_x[0]->second + access_x[2]->second)*0.5;
 						Coord<T> x1 = (access_x[1]->second + access_x[2]->second)*0.5;
 
-						T y0 = (*costFun)(x0.ToVector());
-						T y1 = (*costFun)(x1.ToVector());
+						T y0 = this->evaluate(x0.ToVector());
+						T y1 = this->evaluate(x1.ToVector());
 
 						sort_pop.insert(std::pair<T, Coord<T>>(access_x[2]->first, access_x[2]->second));
 						sort_pop.insert(std::pair<T, Coord<T>>(y0, x0));
@@ -103,7 +171,8 @@ namespace APPRSDK
 				}
 				else if ( y4 >= access_x[0]->first ) {
 					Coord<T> x7 = access_x[0]->second - ((access_x[1]->second + access_x[2]->second)/dim - access_x[0]->second)*0.5;
-					T y7 = (*costFun)(x7.ToVector());
+					this->projectToBoundaries(x7);
+					T y7 = this->evaluate(x7.ToVector());
 
 					if ( y7 < access_x[2]->first ) {
 						sort_pop.insert(std::pair<T, Coord<T>>(y7, x7));
@@ -118,8 +187,8 @@ namespace APPRSDK
 						Coord<T> x0 = (access_x[0]->second + access_x[2]->second)*0.5;
 						Coord<T> x1 = (access_x[1]->second + access_x[2]->second)*0.5;
 
-						T y0 = (*costFun)(x0.ToVector());
-						T y1 = (*costFun)(x1.ToVector());
+						T y0 = this->evaluate(x0.ToVector());
+						T y1 = this->evaluate(x1.ToVector());
 
 						sort_pop.insert(std::pair<T, Coord<T> >(access_x[2]->first, access_x[2]->second));
 						sort_pop.insert(std::pair<T, Coord<T> >(y0, x0));
@@ -136,6 +205,7 @@ namespace APPRSDK
 
 		this->_currentError = access_x[2]->first;
 		this->_currentPosition = access_x[2]->second.ToVector();
+		this->finish((this->_currentError <= this->_maxError) ? MaxErrorReached : (contracted ? Converged : MaxIterationsReached));
 	}
 
 	template<typename T, typename ToBeMinimizedClass>
@@ -145,6 +215,17 @@ namespace APPRSDK
 	    this->_maxIterations = maxIterations;
 	    this->_currentError = 0;
 	    this->_maxError = maxError;
+	    this->_minObjPtr = costFun;
+	    this->_budget.Start();
+	    population.clear();
+
+	    // Warm start: the simplex of a previous optimization replaces the input parameters
+	    OptimizerState<T> state;
+	    bool resume = this->takeResumeState("NM", inputParameters.cols(), state);
+	    if (resume)
+	    {
+	        inputParameters = state.points;
+	    }
 
 	    //Check input parameter compatibility with NM algorithm, and convert input params to Coords.
 	    for (unsigned int i = 0; i < inputParameters.rows(); ++i)
@@ -154,7 +235,8 @@ namespace APPRSDK
 			initVec.resize(tempRowVec.size());
 			ERowVec<T>::Map(&initVec[0], tempRowVec.size()) = tempRowVec;
 			Coord<T> tempCoord(initVec);
-			T tempResult = (*costFun)(tempCoord.ToVector());
+			this->projectToBoundaries(tempCoord);
+			T tempResult = (resume && i < state.values.rows() && this->isReusable(state.values(i))) ? state.values(i) : this->evaluate(tempCoord.ToVector());
 			population.insert(std::pair<T, Coord<T> >(tempResult, tempCoord));
 		}
 
@@ -164,6 +246,46 @@ namespace APPRSDK
 		}
 	}
 
+	/*! \brief GetState
+	 *
+	 * Exports the simplex (best vertex first) with the errors of the vertices. If the
+	 * budget ran out, the best point found replaces the worst vertex, unless it is already
+	 * in the simplex.
+	 */
+	template<typename T, typename ToBeMinimizedClass>
+	OptimizerState<T> NelderMead<T, ToBeMinimizedClass>::GetState()
+	{
+		OptimizerState<T> ret;
+		ret.strategy = "NM";
+		ret.iterations = this->_currentIteration;
+
+		if (population.empty())
+		{
+			return ret;
+		}
+
+		std::multimap<T, Coord<T> > simplex = population;
+		if (this->_currentError < simplex.begin()->first)
+		{
+			std::vector<T> best(this->_currentPosition.size());
+			ERowVec<T>::Map(&best[0], best.size()) = this->_currentPosition;
+			simplex.erase(std::prev(simplex.end()));
+			simplex.insert(std::pair<T, Coord<T> >(this->_currentError, Coord<T>(best)));
+		}
+
+		ret.points.resize(simplex.size(), simplex.begin()->second.size());
+		ret.values.resize(simplex.size());
+
+		unsigned int i = 0;
+		for (typename std::multimap<T, Coord<T> >::iterator it = simplex.begin(); it != simplex.end(); ++it, ++i)
+		{
+			ret.points.row(i) = it->second.ToVector();
+			ret.values(i) = it->first;
+		}
+
+		return ret;
+	}
+
 	template<typename T, typename ToBeMinimizedClass>
 	std::vector<typename std::multimap<T, Coord<T> >::reverse_iterator> NelderMead<T, ToBeMinimizedClass>::setPointers()
 	{
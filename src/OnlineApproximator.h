@@ -0,0 +1,307 @@
+#ifndef __ONLINEAPPROXIMATOR_H_INCLUDED__
+#define __ONLINEAPPROXIMATOR_H_INCLUDED__
+
+#include <chrono>
+#include <vector>
+#include "TypeDefs.h"
+#include "FunctionSystemDerivative.h"
+#include "VariableProjection.h"
+#include "WarmStart.h"
+
+namespace APPRSDK
+{
+    /*! \brief OnlineWindow
+    *
+    * Result of one window of OnlineApproximator. evaluations is the number of objective
+    * evaluations spent on the window, latency the time from the arrival of the last sample
+    * of the window until its approximation was ready (in seconds).
+    */
+    template<typename T>
+    struct OnlineWindow
+    {
+        unsigned long index;
+        unsigned long begin;
+        ERowVec<T> nonLinearParameters;
+        ERowVec<T> linearParameters;
+        T error;
+        unsigned int evaluations;
+        bool warmStarted;
+        bool tracked;
+        double latency;
+
+        OnlineWindow() : index(0), begin(0), error(0), evaluations(0), warmStarted(false), tracked(false), latency(0)
+        {
+
+        }
+    };
+
+    /*! \brief OnlineApproximator
+    *
+    * Continuous approximation of an unsegmented signal: the samples are pushed into a ring
+    * buffer of length m, and every hop h samples the last m samples are approximated by the
+    * VariableProjection, which has to be configured (function system, optimiser, boundaries)
+    * beforehand.
+    *
+    * The windows are not fitted cold. The nonlinear parameters of the previous window are
+    * moved along with the signal (the translation parameter, if any, decreases by h) and
+    * checked first with a single evaluation, which only solves the linear least squares
+    * problem: if the error stays within the tracking ratio of the running mean error of the
+    * optimised windows, the window is accepted as it is (see SetTrackingRatio).
+    * Otherwise the optimiser starts from the moved parameters, keeping the shape of the
+    * initial simplex, and optionally from the moved state of the previous optimisation
+    * (see WarmStart). The cold start
+    * parameters are only used for the first window, after Reset, or when the translation
+    * leaves its boundaries (the tracked wave left the window).
+    */
+    template<typename T>
+    class OnlineApproximator
+    {
+        protected:
+            VariableProjection<T>* _approximator;
+            unsigned int _length;
+            unsigned int _hop;
+            int _translationIndex;
+            ERowVec<T> _lb;
+            ERowVec<T> _ub;
+            T _trackingRatio;
+            WarmStart<T> _warmStart;
+
+            std::vector<T> _ring;
+            unsigned long _position;
+            ERowVec<T> _window;
+            T _meanError;
+
+            OnlineWindow<T> _last;
+            unsigned long _windows;
+            unsigned long _trackedWindows;
+            double _totalLatency;
+            double _maxLatency;
+
+            /*! \brief warmStart
+            *
+            * The parameters of the previous window moved by one hop. Returns false if there
+            * are none or the translation left the boundaries.
+            */
+            bool warmStart(ERowVec<T>& parameters, OptimizerState<T>& state)
+            {
+                if (!_warmStart.HasPrevious())
+                {
+                    return false;
+                }
+
+                parameters = _warmStart.GetPrevious();
+                state = _warmStart.GetPreviousState();
+                if (_translationIndex >= 0 && _translationIndex < parameters.cols())
+                {
+                    parameters(_translationIndex) -= (T)_hop;
+                    if (_lb.cols() == parameters.cols() && parameters(_translationIndex) < _lb(_translationIndex))
+                    {
+                        return false;
+                    }
+                    if (state.points.cols() == parameters.cols())
+                    {
+                        state.points.col(_translationIndex).array() -= (T)_hop;
+                    }
+                }
+                return true;
+            }
+
+            /*! \brief fit
+            *
+            * Approximates the current window. Returns false if it could not be fitted (no
+            * initial parameters were set).
+            */
+            bool fit(std::chrono::steady_clock::time_point arrival)
+            {
+                for (unsigned int i = 0; i < _length; ++i)
+                {
+                    _window(i) = _ring[(_position + i) % _length];
+                }
+                _approximator->SetSignal(_window);
+                unsigned int evaluations = _approximator->GetIterations();
+
+                ERowVec<T> parameters;
+                OptimizerState<T> state;
+                bool warm = warmStart(parameters, state);
+                bool tracked = warm && _trackingRatio > 0 && _meanError > 0 && _approximator->Evaluate(parameters) <= _trackingRatio * _meanError;
+                if (tracked)
+                {
+                    _warmStart.SetPrevious(_approximator->GetNonLinearParameters(), state);
+                }
+                else
+                {
+                    if (!_warmStart.Fit(warm ? parameters : ERowVec<T>(), state))
+                    {
+                        return false;
+                    }
+                    _warmStart.SetPrevious(_approximator->GetNonLinearParameters(), _approximator->GetOptimizerState());
+
+                    // Only the optimised windows count, so that accepted windows cannot drift the threshold
+                    T error = _approximator->GetError();
+                    _meanError = (_meanError == 0) ? error : (T)0.875 * _meanError + (T)0.125 * error;
+                }
+
+                _last.index = _windows++;
+                _last.begin = _position - _length;
+                _last.nonLinearParameters = _warmStart.GetPrevious();
+                _last.linearParameters = _approximator->GetLinearParameters();
+                _last.error = _approximator->GetError();
+                _last.evaluations = _approximator->GetIterations() - evaluations;
+                _last.warmStarted = warm;
+                _last.tracked = tracked;
+                _last.latency = std::chrono::duration<double>(std::chrono::steady_clock::now() - arrival).count();
+
+                _trackedWindows += tracked;
+                _totalLatency += _last.latency;
+                _maxLatency = (_last.latency > _maxLatency) ? _last.latency : _maxLatency;
+                return true;
+            }
+
+        public:
+            /*! \brief Constructor
+            *
+            * length: window length m (the length of the function system), hop: the number of
+            * samples the window advances by.
+            */
+            OnlineApproximator(VariableProjection<T>* approximator, unsigned int length, unsigned int hop)
+                : _approximator(approximator), _length(length), _hop(hop == 0 ? 1 : hop), _translationIndex(1), _trackingRatio(0), _warmStart(approximator, 1),
+                  _ring(length), _window(length)
+            {
+                Reset();
+            }
+
+            /*! \brief SetInitialParameters
+            *
+            * Cold start of the optimiser, see WarmStart::SetInitialParameters. Required: no
+            * window is approximated without it.
+            */
+            void SetInitialParameters(const EMatrix<T>& parameters)
+            {
+                _warmStart.SetInitialParameters(parameters);
+            }
+
+            /*! \brief SetBoundaries
+            *
+            * Sets the boundaries of the optimiser; the translation is checked against them.
+            */
+            void SetBoundaries(const ERowVec<T>& lb, const ERowVec<T>& ub)
+            {
+                _lb = lb;
+                _ub = ub;
+                _approximator->SetBoundaries(lb, ub);
+            }
+
+            /*! \brief SetTranslationIndex
+            *
+            * Index of the translation among the nonlinear parameters (1 for the Hermite
+            * system), -1 if the function system has none.
+            */
+            void SetTranslationIndex(int index)
+            {
+                _translationIndex = index;
+            }
+
+            /*! \brief SetTrackingRatio
+            *
+            * A window is accepted at the warm start without optimisation if its error is at
+            * most ratio times the running mean error of the optimised windows, so the
+            * threshold follows the scale of the signal (0, the default, always optimises).
+            */
+            void SetTrackingRatio(T ratio)
+            {
+                _trackingRatio = ratio;
+            }
+
+            /*! \brief SetReuseOptimizerState
+            *
+            * If true, the optimiser also continues from the moved state of the previous window.
+            * Off by default: the simplex of a converged Nelder-Mead run has collapsed, and
+            * starting from it gave worse fits than the initial simplex moved to the warm start.
+            */
+            void SetReuseOptimizerState(bool reuse)
+            {
+                _warmStart.SetReuseOptimizerState(reuse);
+            }
+
+            /*! \brief Reset
+            *
+            * Starts a new stream: the buffer is emptied and the next fit starts cold.
+            */
+            void Reset()
+            {
+                _position = 0;
+                _warmStart.Reset();
+                _meanError = 0;
+                _windows = 0;
+                _trackedWindows = 0;
+                _totalLatency = 0;
+                _maxLatency = 0;
+            }
+
+            /*! \brief Push
+            *
+            * Adds the next sample. Returns true if a window was approximated (see GetLastWindow).
+            */
+            bool Push(T sample)
+            {
+                std::chrono::steady_clock::time_point arrival = std::chrono::steady_clock::now();
+                _ring[_position % _length] = sample;
+                _position++;
+
+                if (_position < _length || (_position - _length) % _hop != 0)
+                {
+                    return false;
+                }
+                return fit(arrival);
+            }
+
+            /*! \brief Push
+            *
+            * Adds a block of samples; the windows completed are appended to windows if given.
+            * Returns the number of windows completed.
+            */
+            unsigned long Push(const ERowVecRef<T>& samples, std::vector<OnlineWindow<T> >* windows = 0)
+            {
+                unsigned long ret = 0;
+                for (long i = 0; i < samples.cols(); ++i)
+                {
+                    if (Push(samples(i)))
+                    {
+                        ret++;
+                        if (windows != 0)
+                        {
+                            windows->push_back(_last);
+                        }
+                    }
+                }
+                return ret;
+            }
+
+            const OnlineWindow<T>& GetLastWindow()
+            {
+                return _last;
+            }
+
+            unsigned long GetNumberOfWindows()
+            {
+                return _windows;
+            }
+
+            unsigned long GetNumberOfTrackedWindows()
+            {
+                return _trackedWindows;
+            }
+
+            double GetMeanLatency()
+            {
+                return (_windows == 0) ? 0 : _totalLatency / _windows;
+            }
+
+            double GetMaxLatency()
+            {
+                return _maxLatency;
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef __OPTIMIZATIONBUDGET_H_INCLUDED__
+#define __OPTIMIZATIONBUDGET_H_INCLUDED__
+
+#include <chrono>
+#include <limits>
+#include "TypeDefs.h"
+
+namespace APPRSDK
+{
+    /*! \brief Reasons for an optimization to stop.
+    */
+    enum StopReason {NotStopped, MaxErrorReached, MaxIterationsReached, Converged, DeadlineReached, MaxEvaluationsReached, Stagnated};
+
+    /*! \brief OptimizationBudget
+    *
+    * The OptimizationBudget class limits the resources an optimization strategy
+    * may spend on a single fit. The following limits can be set, a value of 0
+    * means that the given limit is not used:
+    * - a wall-clock deadline measured from the start of the optimization
+    * - a maximum number of objective evaluations
+    * - a stagnation rule: the optimization stops if the best error did not improve
+    *   by the given relative amount during the given number of evaluations
+    *
+    * Strategies record every evaluation in the budget, which also keeps track of the
+    * best point found so far, so that it can be returned when the budget runs out.
+    */
+    template<typename T>
+    class OptimizationBudget
+    {
+        protected:
+            double _deadline;
+            unsigned int _maxEvaluations;
+            unsigned int _stagnationWindow;
+            T _minRelativeImprovement;
+
+            std::chrono::steady_clock::time_point _start;
+            double _elapsed;
+            unsigned int _evaluations;
+            unsigned int _evaluationsSinceImprovement;
+            T _referenceError;
+            T _bestError;
+            ERowVec<T> _bestPosition;
+            StopReason _exhaustedReason;
+
+            void updateElapsed()
+            {
+                _elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+            }
+
+        public:
+            OptimizationBudget()
+            {
+                _deadline = 0;
+                _maxEvaluations = 0;
+                _stagnationWindow = 0;
+                _minRelativeImprovement = 0;
+                Start();
+            }
+
+            /*! \brief SetDeadline
+            *
+            * Sets the wall-clock time (in seconds) a single optimization may take.
+            */
+            void SetDeadline(double seconds)
+            {
+                _deadline = seconds;
+            }
+
+            /*! \brief SetMaxEvaluations
+            *
+            * Sets the maximal number of objective evaluations of a single optimization.
+            */
+            void SetMaxEvaluations(unsigned int maxEvaluations)
+            {
+                _maxEvaluations = maxEvaluations;
+            }
+
+            /*! \brief SetStagnation
+            *
+            * The optimization is considered stagnated if the best error did not decrease
+            * by at least minRelativeImprovement (relative to the best error at the
+            * last improvement) during window evaluations.
+            */
+            void SetStagnation(unsigned int window, T minRelativeImprovement)
+            {
+                _stagnationWindow = window;
+                _minRelativeImprovement = minRelativeImprovement;
+            }
+
+            /*! \brief Start
+            *
+            * Resets the runtime state. Called by the strategies at the start of Optimize.
+            */
+            void Start()
+            {
+                _start = std::chrono::steady_clock::now();
+                _elapsed = 0;
+                _evaluations = 0;
+                _evaluationsSinceImprovement = 0;
+                _referenceError = std::numeric_limits<T>::max();
+                _bestError = std::numeric_limits<T>::max();
+                _bestPosition.resize(0);
+                _exhaustedReason = NotStopped;
+            }
+
+            /*! \brief Record
+            *
+            * Records an evaluation of the objective and updates the limits.
+            */
+            void Record(const ERowVec<T>& position, T error)
+            {
+                _evaluations++;
+                _evaluationsSinceImprovement++;
+
+                if (error < _bestError)
+                {
+                    _bestError = error;
+                    _bestPosition = position;
+
+                    if (error <= _referenceError * ((T)1.0 - _minRelativeImprovement))
+                    {
+                        _referenceError = error;
+                        _evaluationsSinceImprovement = 0;
+                    }
+                }
+
+                updateElapsed();
+
+                if (_exhaustedReason != NotStopped)
+                {
+                    return;
+                }
+
+                if (_deadline > 0 && _elapsed >= _deadline)
+                {
+                    _exhaustedReason = DeadlineReached;
+                }
+                else if (_maxEvaluations > 0 && _evaluations >= _maxEvaluations)
+                {
+                    _exhaustedReason = MaxEvaluationsReached;
+                }
+                else if (_stagnationWindow > 0 && _evaluationsSinceImprovement >= _stagnationWindow)
+                {
+                    _exhaustedReason = Stagnated;
+                }
+            }
+
+            /*! \brief Finish
+            *
+            * Stops the clock. Called by the strategies at the end of Optimize.
+            */
+            void Finish()
+            {
+                updateElapsed();
+            }
+
+            /*! \brief IsExhausted
+            *
+            * Returns true if any of the limits has been reached. The deadline is
+            * also checked between evaluations.
+            */
+            bool IsExhausted()
+            {
+                if (_exhaustedReason == NotStopped && _deadline > 0)
+                {
+                    updateElapsed();
+                    if (_elapsed >= _deadline)
+                    {
+                        _exhaustedReason = DeadlineReached;
+                    }
+                }
+                return _exhaustedReason != NotStopped;
+            }
+
+            double GetDeadline()
+            {
+                return _deadline;
+            }
+
+            unsigned int GetMaxEvaluations()
+            {
+                return _maxEvaluations;
+            }
+
+            StopReason GetExhaustedReason()
+            {
+                return _exhaustedReason;
+            }
+
+            double GetElapsedTime()
+            {
+                return _elapsed;
+            }
+
+            unsigned int GetNumberOfEvaluations()
+            {
+                return _evaluations;
+            }
+
+            bool HasBest()
+            {
+                return _bestPosition.size() > 0;
+            }
+
+            ERowVec<T> GetBestPosition()
+            {
+                return _bestPosition;
+            }
+
+            T GetBestError()
+            {
+                return _bestError;
+            }
+    };
+}
+
+#endif
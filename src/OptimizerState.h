@@ -0,0 +1,135 @@
+#ifndef __OPTIMIZERSTATE_H_INCLUDED__
+#define __OPTIMIZERSTATE_H_INCLUDED__
+
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <string>
+#include "TypeDefs.h"
+
+namespace APPRSDK
+{
+    /*! \brief OptimizerState
+    *
+    * Internal state of an optimization strategy, exported with IApproxStrategy::GetState
+    * and imported with IApproxStrategy::SetState, so that an interrupted fit (i.e. by a
+    * deadline) can be continued, or the next fit can start from the state of the previous one.
+    * The meaning of the fields depends on the strategy:
+    * - points: the simplex (Nelder-Mead, one vertex per row) or the current position (one row)
+    * - values: the errors belonging to the points
+    * - damping: the damping of Gauss-Newton or the trust radius of the dogleg method
+    * - residual, jacobian: the linearization at the current position
+    * - history: the correction pairs of L-BFGS (the s vectors, then the y vectors, one per row)
+    *
+    * The state can be written to and read from a stream in a plain text format.
+    */
+    template<typename T>
+    struct OptimizerState
+    {
+        std::string strategy;
+        unsigned int iterations;
+        EMatrix<T> points;
+        EColVec<T> values;
+        T damping;
+        ERowVec<T> residual;
+        EMatrix<T> jacobian;
+        EMatrix<T> history;
+
+        OptimizerState() : iterations(0), damping(0)
+        {
+
+        }
+
+        bool IsEmpty() const
+        {
+            return points.rows() == 0;
+        }
+
+        /*! \brief Save
+        *
+        * Writes the state to the stream (full precision, one field per line).
+        */
+        void Save(std::ostream& out) const
+        {
+            out<<std::setprecision(std::numeric_limits<T>::max_digits10);
+            out<<"strategy "<<(strategy.empty() ? "-" : strategy)<<"\n";
+            out<<"iterations "<<iterations<<"\n";
+            out<<"damping "<<damping<<"\n";
+            saveMatrix(out, "points", points);
+            saveMatrix(out, "values", values);
+            saveMatrix(out, "residual", residual);
+            saveMatrix(out, "jacobian", jacobian);
+            saveMatrix(out, "history", history);
+        }
+
+        /*! \brief Load
+        *
+        * Reads a state written by Save. Returns false if the stream is malformed (including
+        * negative, implausibly large or misshapen matrix sizes).
+        */
+        bool Load(std::istream& in)
+        {
+            std::string key;
+            if (!(in>>key>>strategy) || key != "strategy") return false;
+            if (strategy == "-") strategy.clear();
+            if (!(in>>key>>iterations) || key != "iterations") return false;
+            if (!(in>>key>>damping) || key != "damping") return false;
+
+            return loadMatrix(in, "points", points) && loadMatrix(in, "values", values) &&
+                   loadMatrix(in, "residual", residual) && loadMatrix(in, "jacobian", jacobian) &&
+                   loadMatrix(in, "history", history);
+        }
+
+        protected:
+            // Upper limit of the number of coefficients of a loaded matrix
+            static const long maxElements = 1L << 24;
+
+            template<typename M>
+            static void saveMatrix(std::ostream& out, const char* name, const M& m)
+            {
+                out<<name<<" "<<m.rows()<<" "<<m.cols();
+                for (int i = 0; i < m.rows(); ++i)
+                {
+                    for (int j = 0; j < m.cols(); ++j)
+                    {
+                        out<<" "<<m(i, j);
+                    }
+                }
+                out<<"\n";
+            }
+
+            template<typename M>
+            static bool loadMatrix(std::istream& in, const char* name, M& m)
+            {
+                std::string key;
+                int rows, cols;
+                if (!(in>>key>>rows>>cols) || key != name)
+                {
+                    return false;
+                }
+
+                // Vectors have a fixed dimension, which the stored shape has to match
+                if (rows < 0 || cols < 0 || (cols > 0 && rows > maxElements / cols) ||
+                    (M::RowsAtCompileTime != Eigen::Dynamic && rows != M::RowsAtCompileTime) ||
+                    (M::ColsAtCompileTime != Eigen::Dynamic && cols != M::ColsAtCompileTime))
+                {
+                    return false;
+                }
+
+                m.resize(rows, cols);
+                for (int i = 0; i < rows; ++i)
+                {
+                    for (int j = 0; j < cols; ++j)
+                    {
+                        if (!(in>>m(i, j)))
+                        {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            }
+    };
+}
+
+#endif
@@ -100,6 +100,11 @@ namespace APPRSDK
 
             }
 
+            FunctionSystemDerivative<T>* Clone()
+            {
+                return new OrthonormalHermite<T>(*this);
+            }
+
             T GetDilatation()
             {
                 return _dilatation;
@@ -0,0 +1,111 @@
+#ifndef __ORTHONORMAL_HERMITE_BATCH_INCLUDED__
+#define __ORTHONORMAL_HERMITE_BATCH_INCLUDED__
+
+#include <math.h>
+#include "TypeDefs.h"
+#include "HermiteRecurrence.h"
+
+namespace APPRSDK
+{
+    /*! \brief OrthonormalHermiteBatch function system
+
+    The OrthonormalHermiteBatch class generates the same dilated and translated
+    orthonormal Hermite functions as OrthonormalHermite::ApplyNonLinearParameters, but
+    for Lanes independent parameter sets at once. The values are stored in
+    structure-of-arrays layout: for every sample point and degree the values of all lanes
+    are contiguous, so the recurrence runs on fixed-size Eigen arrays of length Lanes,
+    which Eigen maps to SIMD registers (i.e. Lanes = 4 for double with AVX, 8 for float).
+
+    The functions are generated by the three-term recurrence of the orthonormal
+    Hermite functions (see HermiteRecurrence).
+    */
+    template<typename T, int Lanes>
+    class OrthonormalHermiteBatch
+    {
+        public:
+            typedef Eigen::Array<T, Lanes, 1> LaneVec;
+            typedef Eigen::Array<T, Lanes, Eigen::Dynamic> LaneMatrix;
+
+        protected:
+            unsigned int _numberOfValues;
+            unsigned int _degrees;
+
+            // Column i*_degrees + k holds the kth function at the ith sample for every lane
+            LaneMatrix _functionSystem;
+            HermiteRecurrence<LaneVec> _recurrence;
+
+        public:
+            OrthonormalHermiteBatch(unsigned int numberOfValues, unsigned int degrees)
+            {
+                _numberOfValues = numberOfValues;
+                _degrees = degrees;
+                _functionSystem = LaneMatrix::Zero(Lanes, numberOfValues * degrees);
+            }
+
+            unsigned int GetNumberOfValues()
+            {
+                return _numberOfValues;
+            }
+
+            unsigned int GetDegrees()
+            {
+                return _degrees;
+            }
+
+            /*! \brief ApplyNonLinearParameters
+
+            Generates the function systems of all lanes. The parameters have the same meaning as
+            in OrthonormalHermite::ApplyNonLinearParameters: dilatation(l) is the dilatation
+            and translation(l) is the position (in samples) of the origin for lane l.
+            */
+            void ApplyNonLinearParameters(const LaneVec& dilatation, const LaneVec& translation)
+            {
+                const unsigned int n = _degrees;
+                LaneVec absDilatation = dilatation.abs();
+
+                for (unsigned int i = 0; i < _numberOfValues; ++i)
+                {
+                    const unsigned int base = i * n;
+                    _recurrence.Start(absDilatation * ((T)i - translation));
+                    for (unsigned int k = 0; k < n; ++k)
+                    {
+                        if (k > 0)
+                        {
+                            _recurrence.Next();
+                        }
+                        _functionSystem.col(base + k) = _recurrence.Value();
+                    }
+                }
+            }
+
+            /*! \brief Value
+
+            Returns the values of the kth function at the ith sample for all lanes.
+            */
+            typename LaneMatrix::ColXpr Value(unsigned int i, unsigned int k)
+            {
+                return _functionSystem.col(i * _degrees + k);
+            }
+
+            /*! \brief GetFunctionSystem
+
+            Returns the function system of one lane in the layout of IFunctionSystem::GetFunctionSystem
+            (the functions are in the columns).
+            */
+            EMatrix<T> GetFunctionSystem(unsigned int lane)
+            {
+                EMatrix<T> ret;
+                ret.resize(_numberOfValues, _degrees);
+                for (unsigned int i = 0; i < _numberOfValues; ++i)
+                {
+                    for (unsigned int k = 0; k < _degrees; ++k)
+                    {
+                        ret(i, k) = _functionSystem(lane, i * _degrees + k);
+                    }
+                }
+                return ret;
+            }
+    };
+}
+
+#endif
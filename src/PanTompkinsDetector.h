@@ -0,0 +1,276 @@
+#ifndef __PANTOMPKINSDETECTOR_H_INCLUDED__
+#define __PANTOMPKINSDETECTOR_H_INCLUDED__
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace APPRSDK
+{
+    /*! \brief PanTompkinsDetector
+    *
+    * Streaming R peak detector after Pan and Tompkins: band-pass (5-15 Hz, a biquad
+    * designed for the sampling frequency), five point derivative, squaring and moving
+    * window integration (150 ms). The peaks of the integrated signal are classified as
+    * QRS or noise by adaptive thresholds (SPKI, NPKI), with a refractory period of 200 ms
+    * and a search back for a missed beat if none was found for 1.66 mean RR intervals.
+    * The first 2 s are used to learn the thresholds, beats there are not reported.
+    *
+    * The samples are pushed one by one; when Push returns true, GetPeak tells the position
+    * of the R peak (the maximum of the band-passed signal in the QRS complex). A peak is
+    * reported with a delay of at most about 300 ms (1.66 RR with search back).
+    */
+    template<typename T>
+    class PanTompkinsDetector
+    {
+        protected:
+            double _frequency;
+
+            // Band-pass biquad and its state
+            double _b0, _b2, _a1, _a2;
+            double _x1, _x2, _y1, _y2;
+
+            // Ring buffers: band-passed signal and squared derivative
+            std::vector<double> _bandPassed;
+            std::vector<double> _squared;
+            unsigned long _integrationWidth;
+            double _integral;
+            unsigned long _position;
+
+            // Peak of the integrated signal being followed
+            double _candidate;
+            unsigned long _candidatePosition;
+            double _previousIntegral;
+
+            // Thresholds
+            unsigned long _learningLength;
+            double _learningMax;
+            double _learningSum;
+            double _signalLevel;
+            double _noiseLevel;
+
+            unsigned long _refractory;
+            unsigned long _lastPeak;
+            bool _hasPeak;
+            double _meanRR;
+
+            // Largest noise peak since the last R peak, for the search back
+            double _missedValue;
+            unsigned long _missedPeak;
+
+            unsigned long _peak;
+
+            double bandPassedAt(unsigned long position)
+            {
+                return _bandPassed[position % _bandPassed.size()];
+            }
+
+            double threshold()
+            {
+                return _noiseLevel + 0.25 * (_signalLevel - _noiseLevel);
+            }
+
+            /*! \brief locate
+            *
+            * The R peak of the QRS complex ending at the peak of the integrated signal.
+            */
+            unsigned long locate(unsigned long integralPeak)
+            {
+                unsigned long from = (integralPeak > _integrationWidth + 2) ? integralPeak - _integrationWidth - 2 : 0;
+                unsigned long ret = from;
+                for (unsigned long i = from; i <= integralPeak; ++i)
+                {
+                    ret = (fabs(bandPassedAt(i)) > fabs(bandPassedAt(ret))) ? i : ret;
+                }
+                return ret;
+            }
+
+            void acceptPeak(unsigned long peak, double value, double weight)
+            {
+                if (_hasPeak)
+                {
+                    _meanRR = (_meanRR == 0) ? (double)(peak - _lastPeak) : 0.875 * _meanRR + 0.125 * (peak - _lastPeak);
+                }
+                _signalLevel = weight * value + (1 - weight) * _signalLevel;
+                _lastPeak = peak;
+                _hasPeak = true;
+                _missedValue = 0;
+                _peak = peak;
+            }
+
+            /*! \brief classify
+            *
+            * Classifies a peak of the integrated signal, returns true for a QRS complex.
+            */
+            bool classify(double value, unsigned long integralPeak)
+            {
+                if (integralPeak < _learningLength)
+                {
+                    return false;
+                }
+
+                unsigned long peak = locate(integralPeak);
+                if (value > threshold() && (!_hasPeak || peak > _lastPeak + _refractory))
+                {
+                    acceptPeak(peak, value, 0.125);
+                    return true;
+                }
+
+                _noiseLevel = 0.125 * value + 0.875 * _noiseLevel;
+                if (value > _missedValue && (!_hasPeak || peak > _lastPeak + _refractory))
+                {
+                    _missedValue = value;
+                    _missedPeak = peak;
+                }
+                return false;
+            }
+
+        public:
+            PanTompkinsDetector(double frequency = 360)
+            {
+                SetSamplingFrequency(frequency);
+            }
+
+            /*! \brief SetSamplingFrequency
+            *
+            * Designs the filters for the sampling frequency (in Hz) and resets the detector.
+            */
+            void SetSamplingFrequency(double frequency)
+            {
+                _frequency = frequency;
+
+                // Band-pass with 0 dB gain at sqrt(5 * 15) Hz and 10 Hz bandwidth
+                double center = sqrt(5.0 * 15.0);
+                double w0 = 2 * M_PI * center / frequency;
+                double alpha = sin(w0) / (2 * center / 10.0);
+                _b0 = alpha / (1 + alpha);
+                _b2 = -alpha / (1 + alpha);
+                _a1 = -2 * cos(w0) / (1 + alpha);
+                _a2 = (1 - alpha) / (1 + alpha);
+
+                _integrationWidth = (unsigned long)(0.15 * frequency + 0.5);
+                _integrationWidth = (_integrationWidth == 0) ? 1 : _integrationWidth;
+                _refractory = (unsigned long)(0.2 * frequency);
+                _learningLength = (unsigned long)(2 * frequency);
+                _bandPassed.assign(2 * _integrationWidth + 8, 0);
+                _squared.assign(_integrationWidth, 0);
+
+                Reset();
+            }
+
+            void Reset()
+            {
+                _x1 = _x2 = _y1 = _y2 = 0;
+                std::fill(_bandPassed.begin(), _bandPassed.end(), 0.0);
+                std::fill(_squared.begin(), _squared.end(), 0.0);
+                _integral = 0;
+                _position = 0;
+                _candidate = 0;
+                _candidatePosition = 0;
+                _previousIntegral = 0;
+                _learningMax = 0;
+                _learningSum = 0;
+                _signalLevel = 0;
+                _noiseLevel = 0;
+                _lastPeak = 0;
+                _hasPeak = false;
+                _meanRR = 0;
+                _missedValue = 0;
+                _missedPeak = 0;
+                _peak = 0;
+            }
+
+            double GetSamplingFrequency()
+            {
+                return _frequency;
+            }
+
+            /*! \brief GetPosition
+            *
+            * Number of samples pushed so far.
+            */
+            unsigned long GetPosition()
+            {
+                return _position;
+            }
+
+            /*! \brief GetPeak
+            *
+            * Position of the last R peak reported by Push.
+            */
+            unsigned long GetPeak()
+            {
+                return _peak;
+            }
+
+            /*! \brief GetMaximumDelay
+            *
+            * Bound of the samples pushed after an R peak before it is reported, apart from
+            * peaks found by the search back (which are reported within 1.66 RR).
+            */
+            unsigned long GetMaximumDelay()
+            {
+                return 2 * _integrationWidth + 4;
+            }
+
+            /*! \brief Push
+            *
+            * Processes the next sample, returns true if an R peak was detected.
+            */
+            bool Push(T sample)
+            {
+                double x = sample;
+                double y = _b0 * x + _b2 * _x2 - _a1 * _y1 - _a2 * _y2;
+                _x2 = _x1;
+                _x1 = x;
+                _y2 = _y1;
+                _y1 = y;
+
+                unsigned long n = _position++;
+                _bandPassed[n % _bandPassed.size()] = y;
+
+                // Five point derivative, its square and the moving window integral
+                double derivative = (n < 4) ? 0 : (2 * y + bandPassedAt(n - 1) - bandPassedAt(n - 3) - 2 * bandPassedAt(n - 4)) * _frequency / 8;
+                double squared = derivative * derivative;
+                double& oldest = _squared[n % _squared.size()];
+                _integral += (squared - oldest) / _integrationWidth;
+                oldest = squared;
+                double integral = (_integral > 0) ? _integral : 0;
+
+                if (n < _learningLength)
+                {
+                    _learningMax = (integral > _learningMax) ? integral : _learningMax;
+                    _learningSum += integral;
+                    if (n + 1 == _learningLength)
+                    {
+                        _signalLevel = _learningMax / 3;
+                        _noiseLevel = _learningSum / _learningLength / 2;
+                    }
+                }
+
+                // A peak of the integral is complete when it halved or did not grow for one window
+                bool detected = false;
+                if (integral > _candidate && integral >= _previousIntegral)
+                {
+                    _candidate = integral;
+                    _candidatePosition = n;
+                }
+                else if (_candidate > 0 && (integral < 0.5 * _candidate || n > _candidatePosition + _integrationWidth))
+                {
+                    detected = classify(_candidate, _candidatePosition);
+                    _candidate = 0;
+                }
+                _previousIntegral = integral;
+
+                // Search back: the largest noise peak above half the threshold is taken as missed beat
+                if (!detected && _hasPeak && _meanRR > 0 && n > _lastPeak + 1.66 * _meanRR && _missedValue > 0.5 * threshold())
+                {
+                    acceptPeak(_missedPeak, _missedValue, 0.25);
+                    detected = true;
+                }
+                return detected;
+            }
+    };
+}
+
+#endif
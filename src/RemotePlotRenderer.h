@@ -0,0 +1,400 @@
+#ifndef __REMOTEPLOTRENDERER_H_INCLUDED__
+#define __REMOTEPLOTRENDERER_H_INCLUDED__
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <signal.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "TypeDefs.h"
+
+namespace APPRSDK
+{
+    /*! \brief RemotePlotRenderer
+    *
+    * Renders plots in a separate Python process instead of the embedded interpreter of
+    * matplotlibcpp, so no C++ thread ever takes the GIL. The commands (pyplot function,
+    * arguments, keyword arguments) and the raw array data are streamed over a local
+    * socket to a worker process, which calls the pyplot functions with the Agg backend
+    * (i.e. headless) and saves the figures. Each renderer owns one worker, so a pool of
+    * threads can render in parallel, each with its own renderer, while the fitting goes on.
+    *
+    * A message is a 4 byte length (native byte order), a JSON header and the bytes of the
+    * arrays listed in the header. Sending only waits while the socket buffer is full;
+    * Sync waits until the worker processed everything sent before it.
+    * POSIX only (socketpair, fork, exec).
+    */
+    class RemotePlotRenderer
+    {
+        protected:
+            pid_t _worker;
+            int _socket;
+
+            // Owns the socket and the worker process
+            RemotePlotRenderer(const RemotePlotRenderer&);
+            RemotePlotRenderer& operator=(const RemotePlotRenderer&);
+
+            struct Array
+            {
+                char typecode;
+                const void* data;
+                size_t count;
+                size_t itemSize;
+            };
+
+            static const char* workerScript()
+            {
+                return R"PY(
+import json, os, struct, sys
+import matplotlib
+matplotlib.use('Agg')
+import matplotlib.pyplot as plt
+import numpy
+
+channel = os.fdopen(0, 'rb')
+ack = os.fdopen(os.dup(1), 'wb', 0)
+os.dup2(2, 1)  # output of matplotlib must not mix with the acknowledgements
+errors = 0
+
+def read(n):
+    data = channel.read(n)
+    if len(data) < n:
+        raise EOFError
+    return data
+
+while True:
+    try:
+        size, = struct.unpack('=I', read(4))
+        message = json.loads(read(size).decode('utf-8'))
+        arrays = [numpy.frombuffer(read(count * numpy.dtype(code).itemsize), dtype=code) for code, count in message['arrays']]
+    except EOFError:
+        break
+    command = message['cmd']
+    if command == 'sync':
+        ack.write(('%d\n' % errors).encode())
+        errors = 0
+        continue
+    args = [arrays[a['array']] if isinstance(a, dict) else a for a in message['args']]
+    try:
+        getattr(plt, command)(*args, **message['kwargs'])
+    except Exception as e:
+        errors += 1
+        sys.stderr.write('plot worker: %s failed: %s\n' % (command, e))
+)PY";
+            }
+
+            static std::string quote(const std::string& text)
+            {
+                std::ostringstream ret;
+                ret << '"';
+                for (size_t i = 0; i < text.size(); ++i)
+                {
+                    unsigned char c = text[i];
+                    if (c == '"' || c == '\\')
+                    {
+                        ret << '\\' << c;
+                    }
+                    else if (c < 0x20)
+                    {
+                        char escaped[8];
+                        snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                        ret << escaped;
+                    }
+                    else
+                    {
+                        ret << c;
+                    }
+                }
+                ret << '"';
+                return ret.str();
+            }
+
+            /*! \brief number
+            *
+            * JSON has no NaN or infinity, they are sent as null (i.e. an unset limit).
+            */
+            static std::string number(double value)
+            {
+                if (!std::isfinite(value))
+                {
+                    return "null";
+                }
+
+                std::ostringstream ret;
+                ret.precision(17);
+                ret << value;
+                return ret.str();
+            }
+
+            static std::string arrayArgument(unsigned int index)
+            {
+                std::ostringstream ret;
+                ret << "{\"array\": " << index << "}";
+                return ret.str();
+            }
+
+            bool writeAll(const void* data, size_t size)
+            {
+                const char* bytes = static_cast<const char*>(data);
+                while (size > 0)
+                {
+                    ssize_t written = send(_socket, bytes, size, MSG_NOSIGNAL);
+                    if (written <= 0)
+                    {
+                        return false;
+                    }
+                    bytes += written;
+                    size -= written;
+                }
+                return true;
+            }
+
+            /*! \brief send
+            *
+            * Sends one command. args and kwargs are JSON lists / objects (without the
+            * brackets), {"array": i} in args refers to the ith array.
+            */
+            bool sendCommand(const std::string& command, const std::string& args, const std::string& kwargs, const std::vector<Array>& arrays = std::vector<Array>())
+            {
+                if (!IsRunning())
+                {
+                    return false;
+                }
+
+                std::ostringstream header;
+                header << "{\"cmd\": " << quote(command) << ", \"args\": [" << args << "], \"kwargs\": {" << kwargs << "}, \"arrays\": [";
+                for (size_t i = 0; i < arrays.size(); ++i)
+                {
+                    header << (i ? ", " : "") << "[\"" << arrays[i].typecode << "\", " << arrays[i].count << "]";
+                }
+                header << "]}";
+
+                std::string text = header.str();
+                uint32_t size = text.size();
+                bool ok = writeAll(&size, sizeof(size)) && writeAll(text.data(), text.size());
+                for (size_t i = 0; ok && i < arrays.size(); ++i)
+                {
+                    ok = writeAll(arrays[i].data, arrays[i].count * arrays[i].itemSize);
+                }
+                return ok;
+            }
+
+            template<typename T>
+            static char typecode()
+            {
+                static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value, "Only float and double data can be plotted");
+                return (sizeof(T) == sizeof(float)) ? 'f' : 'd';
+            }
+
+        public:
+            RemotePlotRenderer() : _worker(-1), _socket(-1)
+            {
+
+            }
+
+            ~RemotePlotRenderer()
+            {
+                Stop();
+            }
+
+            /*! \brief Start
+            *
+            * Starts the worker process with the given Python interpreter (it needs
+            * matplotlib and numpy). Returns false if the process could not be started.
+            */
+            bool Start(const std::string& python = "python3")
+            {
+                if (IsRunning())
+                {
+                    return true;
+                }
+
+                int channel[2];
+                if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, channel) != 0)
+                {
+                    return false;
+                }
+
+                _worker = fork();
+                if (_worker == 0)
+                {
+                    // The worker reads the commands from stdin and acknowledges on stdout
+                    dup2(channel[1], 0);
+                    dup2(channel[1], 1);
+                    execlp(python.c_str(), python.c_str(), "-c", workerScript(), (char*)0);
+                    _exit(127);
+                }
+
+                close(channel[1]);
+                if (_worker < 0)
+                {
+                    close(channel[0]);
+                    return false;
+                }
+
+                _socket = channel[0];
+                return true;
+            }
+
+            /*! \brief Stop
+            *
+            * Closes the channel and waits until the worker rendered everything and exited.
+            */
+            void Stop()
+            {
+                if (_socket >= 0)
+                {
+                    close(_socket);
+                    _socket = -1;
+                }
+                if (_worker > 0)
+                {
+                    waitpid(_worker, 0, 0);
+                    _worker = -1;
+                }
+            }
+
+            bool IsRunning()
+            {
+                return _socket >= 0;
+            }
+
+            /*! \brief Sync
+            *
+            * Waits until the worker processed all commands sent so far. Returns the number
+            * of commands that failed since the last Sync, or -1 if the worker is not running
+            * (i.e. the interpreter or matplotlib could not be started).
+            */
+            int Sync()
+            {
+                if (!sendCommand("sync", "", ""))
+                {
+                    return -1;
+                }
+
+                std::string line;
+                char c;
+                while (recv(_socket, &c, 1, 0) == 1)
+                {
+                    if (c == '\n')
+                    {
+                        return atoi(line.c_str());
+                    }
+                    line += c;
+                }
+                return -1;
+            }
+
+            bool Figure(unsigned int width, unsigned int height, unsigned int dpi = 100)
+            {
+                return sendCommand("figure", "", "\"figsize\": [" + number((double)width / dpi) + ", " + number((double)height / dpi) + "], \"dpi\": " + number(dpi));
+            }
+
+            /*! \brief Plot
+            *
+            * Plots y over x (float or double data). The data is sent before the call returns,
+            * so it does not have to outlive the call.
+            */
+            template<typename T>
+            bool Plot(const T* x, const T* y, size_t count, const std::string& format = "", const std::string& label = "")
+            {
+                std::vector<Array> arrays(2);
+                arrays[0].typecode = typecode<T>();
+                arrays[0].data = x;
+                arrays[0].count = count;
+                arrays[0].itemSize = sizeof(T);
+                arrays[1] = arrays[0];
+                arrays[1].data = y;
+
+                std::string kwargs = label.empty() ? "" : "\"label\": " + quote(label);
+                return sendCommand("plot", arrayArgument(0) + ", " + arrayArgument(1) + ", " + quote(format), kwargs, arrays);
+            }
+
+            template<typename T>
+            bool Plot(const std::vector<T>& x, const std::vector<T>& y, const std::string& format = "", const std::string& label = "")
+            {
+                return Plot(x.data(), y.data(), (x.size() < y.size()) ? x.size() : y.size(), format, label);
+            }
+
+            /*! \brief Plot
+            *
+            * Plots y over x given as Eigen vectors (i.e. ERowVec, a row of a block). Plain
+            * vectors are sent as they are, expressions are evaluated first.
+            */
+            template<typename DerivedX, typename DerivedY>
+            bool Plot(const Eigen::MatrixBase<DerivedX>& x, const Eigen::MatrixBase<DerivedY>& y, const std::string& format = "", const std::string& label = "")
+            {
+                typename DerivedX::EvalReturnType xValues = x.eval();
+                typename DerivedY::EvalReturnType yValues = y.eval();
+                return Plot(xValues.data(), yValues.data(), (size_t)((xValues.size() < yValues.size()) ? xValues.size() : yValues.size()), format, label);
+            }
+
+            bool Title(const std::string& title)
+            {
+                return sendCommand("title", quote(title), "");
+            }
+
+            bool XLabel(const std::string& label)
+            {
+                return sendCommand("xlabel", quote(label), "");
+            }
+
+            bool YLabel(const std::string& label)
+            {
+                return sendCommand("ylabel", quote(label), "");
+            }
+
+            bool XLim(double left, double right)
+            {
+                return sendCommand("xlim", number(left) + ", " + number(right), "");
+            }
+
+            bool YLim(double bottom, double top)
+            {
+                return sendCommand("ylim", number(bottom) + ", " + number(top), "");
+            }
+
+            bool Grid(bool flag)
+            {
+                return sendCommand("grid", flag ? "true" : "false", "");
+            }
+
+            bool Legend()
+            {
+                return sendCommand("legend", "", "");
+            }
+
+            bool Clear()
+            {
+                return sendCommand("clf", "", "");
+            }
+
+            /*! \brief Save
+            *
+            * Saves the current figure (the format follows the extension, i.e. PNG).
+            */
+            bool Save(const std::string& filename)
+            {
+                return sendCommand("savefig", quote(filename), "");
+            }
+
+            /*! \brief Close
+            *
+            * Closes all figures of the worker (frees their memory).
+            */
+            bool Close()
+            {
+                return sendCommand("close", "\"all\"", "");
+            }
+    };
+}
+
+#endif
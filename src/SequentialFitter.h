@@ -0,0 +1,230 @@
+#ifndef __SEQUENTIALFITTER_H_INCLUDED__
+#define __SEQUENTIALFITTER_H_INCLUDED__
+
+#include "TypeDefs.h"
+#include "FunctionSystemDerivative.h"
+#include "VariableProjection.h"
+#include "WarmStart.h"
+
+namespace APPRSDK
+{
+    /*! \brief SequentialFitter
+    *
+    * Fits a sequence of beats (i.e. consecutive beats of one patient) with a configured
+    * VariableProjection, each beat starting from the converged nonlinear parameters of the
+    * previous one instead of the constant initial parameters. The initial simplex is moved
+    * to the warm start and shrunk (see SetWarmSimplexScale); optionally the optimiser continues
+    * from the state of the previous fit (see WarmStart).
+    *
+    * The chain is reset on a morphology change, detected from the residual: the relative
+    * residual ||x - approximation|| / ||x|| at the warm start is compared with the running
+    * mean of the converged ones. If it exceeds it by the reset ratio, the beat is fitted
+    * cold. A warm fit that still ends up that far off is refitted cold as well, and the
+    * better fit is kept.
+    */
+    template<typename T>
+    class SequentialFitter
+    {
+        protected:
+            VariableProjection<T>* _approximator;
+            WarmStart<T> _warmStart;
+            T _resetRatio;
+            T _meanResidual;
+
+            unsigned long _beats;
+            unsigned long _warmStarts;
+            unsigned long _resets;
+            unsigned long _evaluations;
+            unsigned int _lastEvaluations;
+            bool _lastWarm;
+            bool _lastReset;
+
+            T relativeResidual(T error, T signalNorm)
+            {
+                return (signalNorm > 0) ? error / signalNorm : error;
+            }
+
+        public:
+            SequentialFitter(VariableProjection<T>* approximator)
+                : _approximator(approximator), _warmStart(approximator, (T)0.5), _resetRatio(2)
+            {
+                Reset();
+            }
+
+            /*! \brief SetInitialParameters
+            *
+            * Cold start of the optimiser, see WarmStart::SetInitialParameters. Required: Fit
+            * fails without it.
+            */
+            void SetInitialParameters(const EMatrix<T>& parameters)
+            {
+                _warmStart.SetInitialParameters(parameters);
+            }
+
+            /*! \brief SetReuseOptimizerState
+            *
+            * If true, the optimiser also continues from the state of the previous beat.
+            */
+            void SetReuseOptimizerState(bool reuse)
+            {
+                _warmStart.SetReuseOptimizerState(reuse);
+            }
+
+            /*! \brief SetWarmSimplexScale
+            *
+            * The initial simplex is scaled by this factor around a warm start (default 0.5),
+            * as the previous beat is expected to be close to the optimum.
+            */
+            void SetWarmSimplexScale(T scale)
+            {
+                _warmStart.SetSimplexScale(scale);
+            }
+
+            /*! \brief SetResetRatio
+            *
+            * A relative residual larger than ratio times the running mean is taken as a
+            * morphology change (default 2).
+            */
+            void SetResetRatio(T ratio)
+            {
+                _resetRatio = ratio;
+            }
+
+            /*! \brief ResetChain
+            *
+            * Starts a new sequence (i.e. the next patient): the next beat is fitted cold and the
+            * running mean residual starts over. The statistics are kept.
+            */
+            void ResetChain()
+            {
+                _warmStart.Reset();
+                _meanResidual = 0;
+                _lastWarm = false;
+                _lastReset = false;
+            }
+
+            /*! \brief ResetStatistics
+            *
+            * Clears the counters (beats, warm starts, resets, evaluations); the chain is kept.
+            */
+            void ResetStatistics()
+            {
+                _beats = 0;
+                _warmStarts = 0;
+                _resets = 0;
+                _evaluations = 0;
+                _lastEvaluations = 0;
+            }
+
+            /*! \brief Reset
+            *
+            * ResetChain and ResetStatistics.
+            */
+            void Reset()
+            {
+                ResetChain();
+                ResetStatistics();
+            }
+
+            /*! \brief Fit
+            *
+            * Fits the next beat; the results are read from the VariableProjection. Returns
+            * false if no initial parameters were set.
+            */
+            bool Fit(const ERowVec<T>& signal)
+            {
+                unsigned int evaluations = _approximator->GetIterations();
+                T signalNorm = signal.norm();
+                _approximator->SetSignal(signal);
+
+                _lastWarm = false;
+                _lastReset = false;
+                if (_warmStart.HasPrevious())
+                {
+                    T residual = relativeResidual(_approximator->Evaluate(_warmStart.GetPrevious()), signalNorm);
+                    _lastWarm = !(_meanResidual > 0 && residual > _resetRatio * _meanResidual);
+                    _lastReset = !_lastWarm;
+                }
+
+                if (!_warmStart.Fit(_lastWarm ? _warmStart.GetPrevious() : ERowVec<T>(), _warmStart.GetPreviousState()))
+                {
+                    _lastWarm = false;
+                    _lastReset = false;
+                    return false;
+                }
+                T residual = relativeResidual(_approximator->GetError(), signalNorm);
+
+                if (_lastWarm && _meanResidual > 0 && residual > _resetRatio * _meanResidual)
+                {
+                    ERowVec<T> warmParameters = _approximator->GetNonLinearParameters();
+                    _warmStart.Fit(ERowVec<T>(), OptimizerState<T>());
+                    T coldResidual = relativeResidual(_approximator->GetError(), signalNorm);
+                    if (coldResidual > residual)
+                    {
+                        _approximator->Evaluate(warmParameters);
+                    }
+                    else
+                    {
+                        residual = coldResidual;
+                    }
+                    _lastReset = true;
+                }
+
+                // The running mean follows slow changes, a reset starts it over
+                _meanResidual = (_lastReset || _meanResidual == 0) ? residual : (T)0.875 * _meanResidual + (T)0.125 * residual;
+                _warmStart.SetPrevious(_approximator->GetNonLinearParameters(), _approximator->GetOptimizerState());
+
+                _beats++;
+                _warmStarts += _lastWarm;
+                _resets += _lastReset;
+                _lastEvaluations = _approximator->GetIterations() - evaluations;
+                _evaluations += _lastEvaluations;
+                return true;
+            }
+
+            /*! \brief WasWarmStarted
+            *
+            * True if the last beat was started from the previous one.
+            */
+            bool WasWarmStarted()
+            {
+                return _lastWarm;
+            }
+
+            /*! \brief WasReset
+            *
+            * True if a morphology change was detected at the last beat.
+            */
+            bool WasReset()
+            {
+                return _lastReset;
+            }
+
+            unsigned int GetLastEvaluations()
+            {
+                return _lastEvaluations;
+            }
+
+            unsigned long GetNumberOfBeats()
+            {
+                return _beats;
+            }
+
+            unsigned long GetNumberOfWarmStarts()
+            {
+                return _warmStarts;
+            }
+
+            unsigned long GetNumberOfResets()
+            {
+                return _resets;
+            }
+
+            double GetMeanEvaluations()
+            {
+                return (_beats == 0) ? 0 : (double)_evaluations / _beats;
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,348 @@
+#ifndef __SIGNALLOADER_H_INCLUDED__
+#define __SIGNALLOADER_H_INCLUDED__
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+#include "TypeDefs.h"
+#include "MappedFile.h"
+
+namespace APPRSDK
+{
+    /*! \brief SignalFileHeader
+    *
+    * Header of the binary signal format: the magic "APPRSIG1", the version (signalFileVersion), the size of a sample
+    * (4: float32, 8: float64), the number of samples, then the samples in native byte
+    * order. The header is 32 bytes, so the samples are aligned for both types.
+    */
+    struct SignalFileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t sampleSize;
+        uint64_t length;
+        uint64_t reserved;
+    };
+
+    const uint32_t signalFileVersion = 1;
+
+    /*! \brief SignalLoader
+    *
+    * Loads signals (i.e. ECG records) from text files with one value per line (or any
+    * whitespace-separated values), and from the binary format of SignalFileHeader.
+    *
+    * The text file is memory-mapped and split into one chunk per thread at whitespace
+    * boundaries. The values of each chunk are counted first, so the vector is allocated
+    * once, then the chunks are parsed in parallel straight into the vector. Decimal values
+    * with at most 15 significant digits (i.e. the 6 decimal values of the test records) are
+    * parsed with one integer accumulation and one exact scaling, which gives the correctly
+    * rounded double; anything else (long mantissas, inf, nan) falls back to strtod.
+    *
+    * The binary file is memory-mapped as well and served as an Eigen::Map without copying;
+    * the map is valid until the loader is closed, destroyed or opens another file.
+    */
+    template<typename T>
+    class SignalLoader
+    {
+        protected:
+            unsigned int _numberOfThreads;
+            MappedFile _file;
+
+            // Below this size a single thread parses faster than several ones start
+            static const size_t minChunkSize = 1 << 20;
+
+            static bool isSpace(char c)
+            {
+                return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',' || c == ';';
+            }
+
+            static unsigned long countValues(const char* begin, const char* end)
+            {
+                unsigned long count = 0;
+                bool inValue = false;
+                for (const char* p = begin; p < end; ++p)
+                {
+                    bool space = isSpace(*p);
+                    count += (!space && !inValue);
+                    inValue = !space;
+                }
+                return count;
+            }
+
+            /*! \brief parseValue
+            *
+            * Parses the value [begin, end) (no whitespace inside).
+            */
+            static bool parseValue(const char* begin, const char* end, T& value)
+            {
+                static const double powersOf10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                                    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+                const char* p = begin;
+                bool negative = (p < end && *p == '-');
+                p += (p < end && (*p == '-' || *p == '+'));
+
+                uint64_t mantissa = 0;
+                int digits = 0;
+                int exponent = 0;
+                bool anyDigit = false;
+                for (; p < end && *p >= '0' && *p <= '9'; ++p)
+                {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    digits += (mantissa != 0);
+                    anyDigit = true;
+                }
+                if (p < end && *p == '.')
+                {
+                    for (++p; p < end && *p >= '0' && *p <= '9'; ++p)
+                    {
+                        mantissa = mantissa * 10 + (*p - '0');
+                        digits += (mantissa != 0);
+                        exponent--;
+                        anyDigit = true;
+                    }
+                }
+                if (anyDigit && p < end && (*p == 'e' || *p == 'E'))
+                {
+                    const char* q = p + 1;
+                    bool negativeExponent = (q < end && *q == '-');
+                    q += (q < end && (*q == '-' || *q == '+'));
+                    int e = 0;
+                    for (; q < end && *q >= '0' && *q <= '9' && e < 10000; ++q)
+                    {
+                        e = e * 10 + (*q - '0');
+                    }
+                    exponent += negativeExponent ? -e : e;
+                    p = q;
+                }
+
+                // Fast path: the mantissa and the power of 10 are exact doubles
+                if (anyDigit && p == end && digits <= 15 && exponent >= -22 && exponent <= 22)
+                {
+                    double result = (exponent < 0) ? mantissa / powersOf10[-exponent] : mantissa * powersOf10[exponent];
+                    value = (T)(negative ? -result : result);
+                    return true;
+                }
+
+                // strtod needs a terminated string, long numbers (i.e. many digits) are copied to the heap
+                char buffer[64];
+                std::string longValue;
+                size_t length = end - begin;
+                char* text = buffer;
+                if (length >= sizeof(buffer))
+                {
+                    longValue.assign(begin, end);
+                    text = &longValue[0];
+                }
+                else
+                {
+                    memcpy(buffer, begin, length);
+                    buffer[length] = 0;
+                }
+
+                char* parsedEnd;
+                value = (T)strtod(text, &parsedEnd);
+                return parsedEnd == text + length;
+            }
+
+            static bool parseValues(const char* begin, const char* end, T* values)
+            {
+                const char* p = begin;
+                while (p < end)
+                {
+                    while (p < end && isSpace(*p))
+                    {
+                        ++p;
+                    }
+                    const char* valueBegin = p;
+                    while (p < end && !isSpace(*p))
+                    {
+                        ++p;
+                    }
+                    if (valueBegin < p && !parseValue(valueBegin, p, *values++))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            static void countChunk(const char* begin, const char* end, unsigned long* count)
+            {
+                *count = countValues(begin, end);
+            }
+
+            static void parseChunk(const char* begin, const char* end, T* values, char* ok)
+            {
+                *ok = parseValues(begin, end, values);
+            }
+
+        public:
+            /*! \brief Constructor
+            *
+            * numberOfThreads = 0 uses all hardware threads.
+            */
+            SignalLoader(unsigned int numberOfThreads = 0)
+            {
+                SetNumberOfThreads(numberOfThreads);
+            }
+
+            void SetNumberOfThreads(unsigned int numberOfThreads)
+            {
+                _numberOfThreads = (numberOfThreads == 0) ? std::thread::hardware_concurrency() : numberOfThreads;
+                _numberOfThreads = (_numberOfThreads == 0) ? 1 : _numberOfThreads;
+            }
+
+            unsigned int GetNumberOfThreads()
+            {
+                return _numberOfThreads;
+            }
+
+            /*! \brief LoadText
+            *
+            * Loads a text file into a row or column vector (ERowVec<T> or EColVec<T>).
+            * Returns false if the file cannot be read or contains something else than numbers.
+            */
+            template<typename Vector>
+            bool LoadText(const std::string& filename, Vector& signal)
+            {
+                MappedFile file;
+                if (!file.Open(filename))
+                {
+                    return false;
+                }
+
+                const char* data = file.GetData();
+                size_t size = file.GetSize();
+
+                // Chunk borders are moved forward to the next whitespace
+                size_t numberOfChunks = std::max<size_t>(1, std::min<size_t>(_numberOfThreads, size / minChunkSize));
+                std::vector<const char*> borders(numberOfChunks + 1, data + size);
+                borders[0] = data;
+                for (size_t c = 1; c < numberOfChunks; ++c)
+                {
+                    const char* border = std::max(data + size * c / numberOfChunks, borders[c - 1]);
+                    while (border < data + size && !isSpace(*border))
+                    {
+                        ++border;
+                    }
+                    borders[c] = border;
+                }
+
+                std::vector<unsigned long> counts(numberOfChunks);
+                std::vector<std::thread> threads;
+                for (size_t c = 1; c < numberOfChunks; ++c)
+                {
+                    threads.push_back(std::thread(&SignalLoader<T>::countChunk, borders[c], borders[c + 1], &counts[c]));
+                }
+                countChunk(borders[0], borders[1], &counts[0]);
+                for (size_t t = 0; t < threads.size(); ++t)
+                {
+                    threads[t].join();
+                }
+
+                unsigned long length = 0;
+                std::vector<unsigned long> offsets(numberOfChunks);
+                for (size_t c = 0; c < numberOfChunks; ++c)
+                {
+                    offsets[c] = length;
+                    length += counts[c];
+                }
+                signal.resize(length);
+
+                // bool is not used as vector<bool> packs the flags
+                std::vector<char> ok(numberOfChunks);
+                threads.clear();
+                for (size_t c = 1; c < numberOfChunks; ++c)
+                {
+                    threads.push_back(std::thread(&SignalLoader<T>::parseChunk, borders[c], borders[c + 1], signal.data() + offsets[c], &ok[c]));
+                }
+                parseChunk(borders[0], borders[1], signal.data(), &ok[0]);
+                for (size_t t = 0; t < threads.size(); ++t)
+                {
+                    threads[t].join();
+                }
+
+                for (size_t c = 0; c < numberOfChunks; ++c)
+                {
+                    if (!ok[c])
+                    {
+                        signal.resize(0);
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            /*! \brief SaveBinary
+            *
+            * Writes the signal in the binary format (with the sample type T).
+            */
+            static bool SaveBinary(const std::string& filename, const ERowVecRef<T>& signal)
+            {
+                SignalFileHeader header;
+                memset(&header, 0, sizeof(header));
+                memcpy(header.magic, "APPRSIG1", 8);
+                header.version = signalFileVersion;
+                header.sampleSize = sizeof(T);
+                header.length = signal.cols();
+
+                std::ofstream file(filename.c_str(), std::ios::binary);
+                file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                file.write(reinterpret_cast<const char*>(signal.data()), signal.cols() * sizeof(T));
+                return file.good();
+            }
+
+            /*! \brief OpenBinary
+            *
+            * Maps a binary signal file. Returns false if the file cannot be mapped, is not
+            * in the binary format (or another version of it), is truncated or holds another
+            * sample type than T.
+            */
+            bool OpenBinary(const std::string& filename)
+            {
+                if (!_file.Open(filename) || _file.GetSize() < sizeof(SignalFileHeader))
+                {
+                    _file.Close();
+                    return false;
+                }
+
+                const SignalFileHeader* header = reinterpret_cast<const SignalFileHeader*>(_file.GetData());
+                if (memcmp(header->magic, "APPRSIG1", 8) != 0 || header->version != signalFileVersion || header->sampleSize != sizeof(T) ||
+                    header->length > (_file.GetSize() - sizeof(SignalFileHeader)) / sizeof(T))
+                {
+                    _file.Close();
+                    return false;
+                }
+                return true;
+            }
+
+            /*! \brief GetSignal
+            *
+            * The signal of the binary file opened by OpenBinary (empty if none is open).
+            */
+            Eigen::Map<const ERowVec<T> > GetSignal()
+            {
+                if (!_file.IsOpen())
+                {
+                    return Eigen::Map<const ERowVec<T> >(0, 0);
+                }
+
+                const SignalFileHeader* header = reinterpret_cast<const SignalFileHeader*>(_file.GetData());
+                return Eigen::Map<const ERowVec<T> >(reinterpret_cast<const T*>(_file.GetData() + sizeof(SignalFileHeader)), header->length);
+            }
+
+            void Close()
+            {
+                _file.Close();
+            }
+    };
+}
+
+#endif
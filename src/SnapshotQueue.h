@@ -0,0 +1,105 @@
+#ifndef __SNAPSHOTQUEUE_H_INCLUDED__
+#define __SNAPSHOTQUEUE_H_INCLUDED__
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+namespace APPRSDK
+{
+    /*! \brief SnapshotQueue
+    *
+    * Bounded lock-free queue for one producer and one consumer thread. The slots are
+    * allocated once, so the producer fills a slot in place (BeginPush / EndPush) and
+    * never allocates or blocks: if the queue is full, the item is dropped and counted.
+    * The consumer takes the items out with TryPop (or only the newest one with TryPopLatest).
+    */
+    template<typename Item>
+    class SnapshotQueue
+    {
+        protected:
+            std::vector<Item> _slots;
+            std::atomic<unsigned int> _head;
+            std::atomic<unsigned int> _tail;
+            std::atomic<unsigned long> _dropped;
+
+            unsigned int next(unsigned int i) const
+            {
+                return (i + 1) % _slots.size();
+            }
+
+        public:
+            /*! \brief Constructor
+            *
+            * capacity is the number of items that can wait in the queue.
+            */
+            SnapshotQueue(unsigned int capacity = 4) : _slots(capacity + 1), _head(0), _tail(0), _dropped(0)
+            {
+
+            }
+
+            /*! \brief BeginPush
+            *
+            * Producer side: returns the slot to be filled, or 0 if the queue is full
+            * (the item is dropped). A returned slot is published by EndPush.
+            */
+            Item* BeginPush()
+            {
+                unsigned int head = _head.load(std::memory_order_relaxed);
+                if (next(head) == _tail.load(std::memory_order_acquire))
+                {
+                    _dropped.fetch_add(1, std::memory_order_relaxed);
+                    return 0;
+                }
+                return &_slots[head];
+            }
+
+            void EndPush()
+            {
+                _head.store(next(_head.load(std::memory_order_relaxed)), std::memory_order_release);
+            }
+
+            /*! \brief TryPop
+            *
+            * Consumer side: swaps the oldest item into item. Returns false if the queue is empty.
+            */
+            bool TryPop(Item& item)
+            {
+                unsigned int tail = _tail.load(std::memory_order_relaxed);
+                if (tail == _head.load(std::memory_order_acquire))
+                {
+                    return false;
+                }
+
+                std::swap(item, _slots[tail]);
+                _tail.store(next(tail), std::memory_order_release);
+                return true;
+            }
+
+            /*! \brief TryPopLatest
+            *
+            * Consumer side: empties the queue and keeps only the newest item. The skipped
+            * items are counted as dropped. Returns false if the queue was empty.
+            */
+            bool TryPopLatest(Item& item)
+            {
+                if (!TryPop(item))
+                {
+                    return false;
+                }
+
+                while (TryPop(item))
+                {
+                    _dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+                return true;
+            }
+
+            unsigned long GetDropped() const
+            {
+                return _dropped.load(std::memory_order_relaxed);
+            }
+    };
+}
+
+#endif
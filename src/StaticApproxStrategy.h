@@ -0,0 +1,302 @@
+#ifndef __STATICAPPROXSTRATEGY_H_INCLUDED__
+#define __STATICAPPROXSTRATEGY_H_INCLUDED__
+
+#include <limits>
+#include "TypeDefs.h"
+#include "OptimizationBudget.h"
+
+namespace APPRSDK
+{
+    /*! \brief StaticApproxStrategyBase
+    *
+    * Compile-time counterpart of ApproxStrategyBase. The concrete strategy is given as the
+    * Derived template parameter (CRTP), the objective as the Objective template parameter,
+    * so neither the strategy nor the objective is called through a virtual function.
+    * The objective has to provide the following method:
+    * T Evaluate(const ERowVecRef<T>& position)
+    * which is implemented by VariableProjection. The concrete strategy implements
+    * bool optimize(const EMatrixRef<T>& inputParameters), which returns false if it cannot
+    * start from the input. The virtual IApproxStrategy interface remains available for
+    * strategies that are selected at runtime.
+    */
+    template<typename Derived, typename T, typename Objective>
+    class StaticApproxStrategyBase
+    {
+        protected:
+            unsigned int _maxIterations;
+            unsigned int _currentIteration;
+            T _maxError;
+            T _currentError;
+            ERowVec<T> _currentPosition;
+            Objective* _objective;
+
+            ERowVec<T> _lb;
+            ERowVec<T> _ub;
+
+            OptimizationBudget<T> _budget;
+            StopReason _stopReason;
+
+            /*! \brief evaluate
+            *
+            * As ApproxStrategyBase::evaluate: once the budget is exhausted the objective is not
+            * called anymore, and the largest representable value is returned.
+            */
+            T evaluate(const ERowVecRef<T>& position)
+            {
+                if (_budget.IsExhausted())
+                {
+                    return std::numeric_limits<T>::max();
+                }
+
+                T ret = _objective->Evaluate(position);
+                _budget.Record(position, ret);
+                return ret;
+            }
+
+            /*! \brief projectToBoundaries
+            *
+            * Clamps each coordinate of x into [_lb, _ub] if boundaries were set.
+            */
+            template<typename Vec>
+            void projectToBoundaries(Vec& x)
+            {
+                if (_lb.size() != x.size() || _ub.size() != x.size())
+                {
+                    return;
+                }
+
+                x = x.cwiseMax(_lb).cwiseMin(_ub);
+            }
+
+        public:
+            StaticApproxStrategyBase() : _maxIterations(0), _currentIteration(0), _maxError(0), _currentError(0), _objective(0), _stopReason(NotStopped)
+            {
+
+            }
+
+            /*! \brief Optimize
+            *
+            * Runs the optimization of the concrete strategy. inputParameters holds the
+            * starting point(s) in its rows. Returns false if the strategy rejected the input;
+            * then nothing is evaluated and the stop reason is NotStopped. If the budget ran
+            * out, its reason is reported and the best point found so far is returned.
+            */
+            bool Optimize(T maxError, unsigned int maxIterations, const EMatrixRef<T>& inputParameters, Objective& objective)
+            {
+                _maxError = maxError;
+                _maxIterations = maxIterations;
+                _currentIteration = 0;
+                _currentError = std::numeric_limits<T>::max();
+                _currentPosition = (inputParameters.rows() > 0) ? ERowVec<T>(inputParameters.row(0)) : ERowVec<T>();
+                _stopReason = NotStopped;
+                _objective = &objective;
+                _budget.Start();
+
+                bool ret = static_cast<Derived*>(this)->optimize(inputParameters);
+
+                _budget.Finish();
+                if (!ret)
+                {
+                    return false;
+                }
+                if (_budget.GetExhaustedReason() != NotStopped)
+                {
+                    _stopReason = _budget.GetExhaustedReason();
+                }
+                if (_budget.HasBest() && _budget.GetBestError() < _currentError)
+                {
+                    _currentPosition = _budget.GetBestPosition();
+                    _currentError = _budget.GetBestError();
+                }
+                return true;
+            }
+
+            int GetIterations()
+            {
+                return _currentIteration;
+            }
+
+            T GetCurrentError()
+            {
+                return _currentError;
+            }
+
+            ERowVec<T> GetPosition()
+            {
+                return _currentPosition;
+            }
+
+            void SetBoundaries(ERowVec<T> lb, ERowVec<T> ub)
+            {
+                _lb = lb;
+                _ub = ub;
+            }
+
+            void SetBudget(OptimizationBudget<T> budget)
+            {
+                _budget = budget;
+            }
+
+            StopReason GetStopReason()
+            {
+                return _stopReason;
+            }
+
+            double GetElapsedTime()
+            {
+                return _budget.GetElapsedTime();
+            }
+
+            unsigned int GetNumberOfEvaluations()
+            {
+                return _budget.GetNumberOfEvaluations();
+            }
+    };
+
+    /*! \brief StaticNelderMead
+    *
+    * Nelder-Mead simplex method for any number of parameters on top of StaticApproxStrategyBase.
+    * The simplex is kept in a row-major Eigen matrix (one vertex per row) and the trial points
+    * are preallocated, so an iteration does not allocate memory. The input has to contain
+    * n+1 starting vertices for n parameters, otherwise it is rejected. Reflected and
+    * expanded points are projected into the boundaries, if they were set.
+    */
+    template<typename T, typename Objective>
+    class StaticNelderMead : public StaticApproxStrategyBase<StaticNelderMead<T, Objective>, T, Objective>
+    {
+        protected:
+            Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> _simplex;
+            EColVec<T> _values;
+            ERowVec<T> _centroid;
+            ERowVec<T> _reflected;
+            ERowVec<T> _trial;
+
+        public:
+            bool optimize(const EMatrixRef<T>& inputParameters)
+            {
+                const int n = inputParameters.cols();
+                const int v = inputParameters.rows();
+                if (n == 0 || v != n + 1)
+                {
+                    return false;
+                }
+
+                _simplex = inputParameters;
+                _values.resize(v);
+                _centroid.resize(n);
+                _reflected.resize(n);
+                _trial.resize(n);
+
+                for (int i = 0; i < v; ++i)
+                {
+                    _trial = _simplex.row(i);
+                    this->projectToBoundaries(_trial);
+                    _simplex.row(i) = _trial;
+                    _values(i) = this->evaluate(_simplex.row(i));
+                }
+
+                int best = 0;
+                int worst = 0;
+                int secondWorst = 0;
+
+                while (!this->_budget.IsExhausted())
+                {
+                    // Order: best, worst and second worst vertices
+                    best = 0;
+                    worst = 0;
+                    for (int i = 1; i < v; ++i)
+                    {
+                        if (_values(i) < _values(best)) best = i;
+                        if (_values(i) > _values(worst)) worst = i;
+                    }
+                    secondWorst = best;
+                    for (int i = 0; i < v; ++i)
+                    {
+                        if (i != worst && _values(i) > _values(secondWorst)) secondWorst = i;
+                    }
+
+                    if (_values(best) <= this->_maxError || this->_currentIteration >= this->_maxIterations)
+                    {
+                        break;
+                    }
+
+                    this->_currentIteration++;
+
+                    _centroid = (_simplex.colwise().sum() - _simplex.row(worst)) / (T)(v - 1);
+
+                    // Reflection
+                    _reflected = _centroid + (_centroid - _simplex.row(worst));
+                    this->projectToBoundaries(_reflected);
+                    T yr = this->evaluate(_reflected);
+
+                    if (yr < _values(best))
+                    {
+                        // Expansion
+                        _trial = _centroid + (T)2.0 * (_centroid - _simplex.row(worst));
+                        this->projectToBoundaries(_trial);
+                        T ye = this->evaluate(_trial);
+                        if (ye < yr)
+                        {
+                            _simplex.row(worst) = _trial;
+                            _values(worst) = ye;
+                        }
+                        else
+                        {
+                            _simplex.row(worst) = _reflected;
+                            _values(worst) = yr;
+                        }
+                        continue;
+                    }
+
+                    if (yr < _values(secondWorst))
+                    {
+                        _simplex.row(worst) = _reflected;
+                        _values(worst) = yr;
+                        continue;
+                    }
+
+                    // Contraction, outside if the reflected point is better than the worst vertex
+                    if (yr < _values(worst))
+                    {
+                        _trial = _centroid + (T)0.5 * (_reflected - _centroid);
+                    }
+                    else
+                    {
+                        _trial = _centroid + (T)0.5 * (_simplex.row(worst) - _centroid);
+                    }
+                    T yc = this->evaluate(_trial);
+
+                    if (yc < ((yr < _values(worst)) ? yr : _values(worst)))
+                    {
+                        _simplex.row(worst) = _trial;
+                        _values(worst) = yc;
+                        continue;
+                    }
+
+                    // Shrink towards the best vertex
+                    for (int i = 0; i < v; ++i)
+                    {
+                        if (i == best)
+                        {
+                            continue;
+                        }
+                        _simplex.row(i) = _simplex.row(best) + (T)0.5 * (_simplex.row(i) - _simplex.row(best));
+                        _values(i) = this->evaluate(_simplex.row(i));
+                    }
+                }
+
+                best = 0;
+                for (int i = 1; i < v; ++i)
+                {
+                    if (_values(i) < _values(best)) best = i;
+                }
+
+                this->_currentPosition = _simplex.row(best);
+                this->_currentError = _values(best);
+                this->_stopReason = (this->_currentError <= this->_maxError) ? MaxErrorReached : MaxIterationsReached;
+                return true;
+            }
+    };
+}
+
+#endif
@@ -6,6 +6,9 @@
 template<typename T>
 using EMatrix = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
 
+template<typename T>
+using ERowMajorMatrix = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
 template<typename T>
 using ERowVec = Eigen::Matrix<T, 1, Eigen::Dynamic>;
 
@@ -21,4 +24,10 @@ using EARowVec = Eigen::Array<T, 1, Eigen::Dynamic>;
 template<typename T>
 using EAColVec = Eigen::Array<T, Eigen::Dynamic, 1>;
 
+template<typename T>
+using ERowVecRef = Eigen::Ref<const ERowVec<T> >;
+
+template<typename T>
+using EMatrixRef = Eigen::Ref<const EMatrix<T> >;
+
 #endif
\ No newline at end of file
@@ -3,11 +3,20 @@
 
 #include <iostream>
 #include <thread>
+#include <chrono>
 #include "IOptimazible.h"
 #include "MatHelper.h"
 #include "NelderMead.h"
 #include "matplotlibcpp.h"
 #include "LevenbergMarquardt.h"
+#include "GaussNewton.h"
+#include "Dogleg.h"
+#include "LimitedMemoryBFGS.h"
+#include "HybridStrategy.h"
+#include "EvaluationCache.h"
+#include "FiniteDifferenceJacobian.h"
+#include "AsyncPlotter.h"
+#include "IterationObservers.h"
 #include <Eigen/QR>
 //#include "ApproxStat.h"
 
@@ -21,10 +30,14 @@ namespace APPRSDK
  * The VariableProjection class implements the IOptimazible interface.
  * VariableProjection type objects are capable of conducting an approximation
  * with different parameters, and sharing statistical information about it.
+ *
+ * The ObserverPolicy decides how the evaluations are reported (see IIterationObserver.h).
+ * With the default NoObserverPolicy the reporting compiles away; with RuntimeObserverPolicy
+ * an observer can be set with SetObserver.
  */
 
-template<typename T>
-class VariableProjection : public IOptimazible<T>
+template<typename T, typename ObserverPolicy = NoObserverPolicy<T> >
+class VariableProjection : public IOptimazible<T>, public ObserverPolicy
 {
 	private:
 		ERowVec<T> _signal;
@@ -39,18 +52,35 @@ class VariableProjection : public IOptimazible<T>
 
 		T _maximumErrorForOptimisation;
 		T _currentError;
+		double _fitTime;
+		StopReason _stopReason;
 
 		unsigned int _iterations;
 		unsigned int _maximumNumberOfIterationsForOptimisation;
 
-		IApproxStrategy<T, VariableProjection<T>* >* _approximationStrategy;
+		IApproxStrategy<T, VariableProjection<T, ObserverPolicy>* >* _approximationStrategy;
 		FunctionSystemDerivative<T>* _functionSystem;
+		EvaluationCache<T> _cache;
+		FiniteDifferenceJacobian<T, VariableProjection<T, ObserverPolicy> >* _finiteDifference;
+		bool _ownsFunctionSystem;
+
+		AsyncPlotter<T>* _plotter;
 
-		bool _show = false;
+		// Owns the finite difference contexts, the plotter and (for clones) the function system
+		VariableProjection(const VariableProjection<T, ObserverPolicy>&);
+		VariableProjection<T, ObserverPolicy>& operator=(const VariableProjection<T, ObserverPolicy>&);
 
         bool checkInput();
 		
-		void formJacobian();
+		void formJacobian(bool withJacobian = true);
+		void invalidateFiniteDifferenceContexts()
+		{
+			if (_finiteDifference != 0)
+			{
+				_finiteDifference->Clear();
+			}
+		}
+		void evaluate(const ERowVecRef<T>& nonLinParams);
 		void InitParamsForOptimiser(int numberOfParamVecsNeeded);
 
 	public:
@@ -63,12 +93,13 @@ class VariableProjection : public IOptimazible<T>
 		ERowVec<T> GetLinearParameters();
 		EMatrix<T> GetWeights();
 		EMatrix<T> GetJacobian();
+		ERowVec<T> GetResidual();
 		unsigned int GetMaxIterationForOptimisation();
 		T GetMaxErrorForOptimisation();
 
 		void SetSignal(ERowVec<T> signal);
 		void SetFunctionSystem(FunctionSystemDerivative<T>* functionSystem);
-		void SetOptimiser(IApproxStrategy<T, IOptimazible<T> >* approximationStrategy);
+		void SetOptimiser(IApproxStrategy<T, VariableProjection<T, ObserverPolicy>* >* approximationStrategy);
 		void SetMaxIterationForOptimisation(unsigned int maxIteration);
 		void SetNonLinParams(ERowVec<T> NonLinParams);
 		void SetMaxErrorForOptimisation(T maxErr);
@@ -77,33 +108,44 @@ class VariableProjection : public IOptimazible<T>
 		void SelectOptimiser(AvailableOptimizers optimName, bool initaliseParameters=false);
 		void Varpro();
 
+		template<typename StaticStrategy>
+		void Varpro(StaticStrategy& strategy);
+
 		T operator ()(ERowVec<T> nonLinParams)
+		{
+			return Evaluate(nonLinParams);
+		}
+
+		/*! \brief Evaluate
+		*
+		*	Non-virtual evaluation of the objective used by the static strategies
+		*	(see StaticApproxStrategy.h). The parameters are passed by reference, so
+		*	the call can be inlined and no temporary vector is created.
+		*/
+		T Evaluate(const ERowVecRef<T>& nonLinParams)
 		{
 			_iterations++;
 			_nonLinParams = nonLinParams;
-			_functionSystem->ApplyNonLinearParameters(nonLinParams);
-			formJacobian();
-			std::cout<<"current position: "<<nonLinParams<<std::endl;
-			std::cout<<"current error: "<<_currentError<<std::endl;
 
-			if (_show)
+			ObserverLevel level = this->getObserverLevel();
+			if (level == ObserveTiming)
 			{
-				std::vector<T> x, y_sig, y_apr;
-				
-				for (int i = 0; i < _signal.cols(); ++i)
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				evaluate(nonLinParams);
+				this->notifyObserver(_iterations, nonLinParams, _currentError, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+			}
+			else
+			{
+				evaluate(nonLinParams);
+				if (level != ObserveNothing)
 				{
-					x.push_back(i);
-					y_sig.push_back(_signal(0, i));
-					y_apr.push_back(_approximation(0, i));
+					this->notifyObserver(_iterations, nonLinParams, _currentError, 0.0);
 				}
+			}
 
-				plt::clf();
-				plt::named_plot("signal", x, y_sig);
-				plt::named_plot("approximation", x, y_apr, "r-");
-				plt::legend();
-				plt::title("APPRSDK Demo");
-				plt::show();
-				plt::pause(0.1);
+			if (_plotter != 0)
+			{
+				_plotter->Publish(_signal, _approximation, nonLinParams, _currentError);
 			}
 
 			return _currentError;
@@ -111,7 +153,70 @@ class VariableProjection : public IOptimazible<T>
 
 		bool HasJacobianInfo()
 		{
-			return (_functionSystem->GetIndex().cols() != 0 || _functionSystem->GetIndex().rows() != 0);
+			return (_finiteDifference != 0 || _functionSystem->GetIndex().cols() != 0 || _functionSystem->GetIndex().rows() != 0);
+		}
+
+		/*! \brief SetFiniteDifferenceJacobian
+		*
+		*	Replaces the analytic Jacobian by a finite difference approximation that is
+		*	evaluated on numberOfThreads clones of this object (0: one per hardware thread).
+		*	Meant for function systems without partial derivatives. The function system has to
+		*	be set before and has to implement Clone; otherwise false is returned and the
+		*	analytic Jacobian is kept.
+		*/
+		bool SetFiniteDifferenceJacobian(FiniteDifferenceScheme scheme, unsigned int numberOfThreads = 0)
+		{
+			if (_functionSystem == 0)
+			{
+				return false;
+			}
+
+			FunctionSystemDerivative<T>* probe = _functionSystem->Clone();
+			if (probe == 0)
+			{
+				return false;
+			}
+			delete probe;
+
+			delete _finiteDifference;
+			_finiteDifference = new FiniteDifferenceJacobian<T, VariableProjection<T, ObserverPolicy> >(scheme, numberOfThreads);
+			_cache.Clear();
+			return true;
+		}
+
+		/*! \brief Clone
+		*
+		*	Returns an independent copy (signal, weights, function system) used as a thread
+		*	context by FiniteDifferenceJacobian. Returns 0 if the function system can not be cloned.
+		*/
+		VariableProjection<T, ObserverPolicy>* Clone()
+		{
+			FunctionSystemDerivative<T>* functionSystem = _functionSystem->Clone();
+			if (functionSystem == 0)
+			{
+				return 0;
+			}
+
+			VariableProjection<T, ObserverPolicy>* ret = new VariableProjection<T, ObserverPolicy>();
+			ret->_functionSystem = functionSystem;
+			ret->_ownsFunctionSystem = true;
+			ret->_signal = _signal;
+			ret->_weights = _weights;
+			ret->_nonLinParams = _nonLinParams;
+			ret->_cache.SetCapacity(0);
+			return ret;
+		}
+
+		/*! \brief EvaluateResidual
+		*
+		*	Evaluates the weighted residual without the Jacobian.
+		*/
+		void EvaluateResidual(const ERowVecRef<T>& nonLinParams, ERowVec<T>& residual)
+		{
+			_nonLinParams = nonLinParams;
+			_functionSystem->ApplyNonLinearParameters(_nonLinParams);
+			formJacobian(false);
+			residual = _weighedResidual;
 		}
 
 		unsigned int GetIterations()
@@ -132,20 +237,126 @@ class VariableProjection : public IOptimazible<T>
 			}
 		}
 
+		/*! \brief SetBudget
+		*
+		*	Sets the time and evaluation budget of the selected optimiser.
+		*/
+		void SetBudget(OptimizationBudget<T> budget)
+		{
+			if (_approximationStrategy != 0)
+			{
+				_approximationStrategy->SetBudget(budget);
+			}
+		}
+
+		/*! \brief GetOptimizerState
+		*
+		*	Returns the internal state of the selected optimiser after the last call of Varpro.
+		*/
+		OptimizerState<T> GetOptimizerState()
+		{
+			if (_approximationStrategy != 0)
+			{
+				return _approximationStrategy->GetState();
+			}
+			return OptimizerState<T>();
+		}
+
+		/*! \brief SetOptimizerState
+		*
+		*	The next call of Varpro starts the optimiser from the given state (i.e. the one of the
+		*	previous signal). reuseValues may only be true if the signal and the weights did not
+		*	change, i.e. when an interrupted fit is continued.
+		*/
+		void SetOptimizerState(const OptimizerState<T>& state, bool reuseValues = false)
+		{
+			if (_approximationStrategy != 0)
+			{
+				_approximationStrategy->SetState(state, reuseValues);
+			}
+		}
+
+		/*! \brief GetStopReason
+		*
+		*	Returns why the optimiser stopped during the last call of Varpro.
+		*/
+		StopReason GetStopReason()
+		{
+			return _stopReason;
+		}
+
+		/*! \brief GetFitTime
+		*
+		*	Returns the wall-clock time (in seconds) of the last call of Varpro.
+		*/
+		double GetFitTime()
+		{
+			return _fitTime;
+		}
+
+		/*! \brief SetShow
+		*
+		*	Turns the live plot of the approximation on or off. The plot is drawn by an
+		*	AsyncPlotter thread, the evaluations only publish snapshots to it and never
+		*	wait for the drawing (frames are dropped if the plot is slower).
+		*/
 		void SetShow(bool show)
 		{
-			_show = show;
+			if (show)
+			{
+				if (_plotter == 0)
+				{
+					_plotter = new AsyncPlotter<T>();
+				}
+				_plotter->Start();
+			}
+			else if (_plotter != 0)
+			{
+				_plotter->Stop();
+			}
+		}
+
+		AsyncPlotter<T>* GetPlotter()
+		{
+			return _plotter;
+		}
+
+		/*! \brief SetCacheOptions
+		*
+		*	Sets the capacity and the key matching tolerance of the evaluation cache.
+		*	A capacity of 0 disables caching, a tolerance of 0 means exact matching.
+		*/
+		void SetCacheOptions(unsigned int capacity, T tolerance)
+		{
+			_cache.Clear();
+			_cache.SetCapacity(capacity);
+			_cache.SetTolerance(tolerance);
+		}
+
+		EvaluationCache<T>& GetCache()
+		{
+			return _cache;
+		}
+
+		double GetCacheHitRate()
+		{
+			return _cache.GetHitRate();
 		}
 };
 
 /*! \brief Constructor
 */
-template<typename T>
-VariableProjection<T>::VariableProjection()
+template<typename T, typename ObserverPolicy>
+VariableProjection<T, ObserverPolicy>::VariableProjection()
 {
 	_approximationStrategy = 0;
 	_functionSystem = 0;
+	_finiteDifference = 0;
+	_plotter = 0;
+	_ownsFunctionSystem = false;
 	_iterations = 0;
+	_fitTime = 0;
+	_stopReason = NotStopped;
 	_signal.resize(0);
 	_approximation.resize(0);
 	_nonLinParams.resize(0);
@@ -154,20 +365,28 @@ VariableProjection<T>::VariableProjection()
 
 /*! \brief Destructor
 */
-template<typename T>
-VariableProjection<T>::~VariableProjection()
-{}
+template<typename T, typename ObserverPolicy>
+VariableProjection<T, ObserverPolicy>::~VariableProjection()
+{
+	delete _plotter;
+	delete _finiteDifference;
+
+	if (_ownsFunctionSystem)
+	{
+		delete _functionSystem;
+	}
+}
 
 /*! \brief SelectOptimiser
 *
 *	Selects an optimiser of the available ones
 */
-template<typename T>
-void VariableProjection<T>::SelectOptimiser(AvailableOptimizers optimName, bool initaliseParameters)
+template<typename T, typename ObserverPolicy>
+void VariableProjection<T, ObserverPolicy>::SelectOptimiser(AvailableOptimizers optimName, bool initaliseParameters)
 {
 	if (optimName == NM)
 	{
-		_approximationStrategy = new NelderMead<T, VariableProjection<T>* >();
+		_approximationStrategy = new NelderMead<T, VariableProjection<T, ObserverPolicy>* >();
 		if (initaliseParameters)
 		{
 			InitParamsForOptimiser(3);
@@ -175,12 +394,44 @@ void VariableProjection<T>::SelectOptimiser(AvailableOptimizers optimName, bool
 	}
 	else if (optimName == LM)
 	{
-		_approximationStrategy = new LevenbergMarquardt<T, VariableProjection<T>* >();
+		_approximationStrategy = new LevenbergMarquardt<T, VariableProjection<T, ObserverPolicy>* >();
+		if (initaliseParameters)
+		{
+			InitParamsForOptimiser(1);
+		}
+	}
+	else if (optimName == GN)
+	{
+		_approximationStrategy = new GaussNewton<T, VariableProjection<T, ObserverPolicy>* >();
+		if (initaliseParameters)
+		{
+			InitParamsForOptimiser(1);
+		}
+	}
+	else if (optimName == DL)
+	{
+		_approximationStrategy = new Dogleg<T, VariableProjection<T, ObserverPolicy>* >();
 		if (initaliseParameters)
 		{
 			InitParamsForOptimiser(1);
 		}
 	}
+	else if (optimName == LBFGS)
+	{
+		_approximationStrategy = new LimitedMemoryBFGS<T, VariableProjection<T, ObserverPolicy>* >();
+		if (initaliseParameters)
+		{
+			InitParamsForOptimiser(1);
+		}
+	}
+	else if (optimName == HYBRID)
+	{
+		_approximationStrategy = new HybridStrategy<T, VariableProjection<T, ObserverPolicy>* >();
+		if (initaliseParameters)
+		{
+			InitParamsForOptimiser(3);
+		}
+	}
 	else
 	{
 		//TODO: Throw error exception
@@ -194,8 +445,8 @@ void VariableProjection<T>::SelectOptimiser(AvailableOptimizers optimName, bool
 *	himself comes up with the starting points, as this can greatly
 *	increase efficiency of the optimization.
 */
-template<typename T>
-void VariableProjection<T>::InitParamsForOptimiser(int numberOfParamVecsNeeded)
+template<typename T, typename ObserverPolicy>
+void VariableProjection<T, ObserverPolicy>::InitParamsForOptimiser(int numberOfParamVecsNeeded)
 {
 	_initialParamsForOptimiser.resize(numberOfParamVecsNeeded, _nonLinParams.cols());
 	
@@ -220,18 +471,29 @@ void VariableProjection<T>::InitParamsForOptimiser(int numberOfParamVecsNeeded)
 *
 *	Sets the initial non linear parameters
 */
-template<typename T>
-void VariableProjection<T>::SetNonLinParams(ERowVec<T> NonLinParams)
+template<typename T, typename ObserverPolicy>
+void VariableProjection<T, ObserverPolicy>::SetNonLinParams(ERowVec<T> NonLinParams)
 {
 	_nonLinParams = NonLinParams;
 }
 
+/*! \brief SetInitalParametersForOptimiser
+*
+*	Sets the starting points of the optimiser. Each row is a starting point,
+*	the number of rows needed depends on the selected optimiser.
+*/
+template<typename T, typename ObserverPolicy>
+void VariableProjection<T, ObserverPolicy>::SetInitalParametersForOptimiser(EMatrix<T> initialParameters)
+{
+	_initialParamsForOptimiser = initialParameters;
+}
+
 /*! \brief GetMaxIterationForOptimisation
-*	
+*
 *	Get the currently set number of iterations
 */
-template<typename T>
-unsigned int VariableProjection<T>::GetMaxIterationForOptimisation()
+template<typename T, typename ObserverPolicy>
+unsigned int VariableProjection<T, ObserverPolicy>::GetMaxIterationForOptimisation()
 {
 	return _maximumNumberOfIterationsForOptimisation;
 }
@@ -240,8 +502,8 @@ unsigned int VariableProjection<T>::GetMaxIterationForOptimisation()
 *	
 *	Get the currently set maximal tolarable error for the optimisation
 */
-template<typename T>
-T VariableProjection<T>::GetMaxErrorForOptimisation()
+template<typename T, typename ObserverPolicy>
+T VariableProjection<T, ObserverPolicy>::GetMaxErrorForOptimisation()
 {
 	return _maximumErrorForOptimisation;
 }
@@ -250,8 +512,8 @@ T VariableProjection<T>::GetMaxErrorForOptimisation()
 *	
 *	Return the model
 */
-template<typename T>
-ERowVec<T> VariableProjection<T>::GetApproximation()
+template<typename T, typename ObserverPolicy>
+ERowVec<T> VariableProjection<T, ObserverPolicy>::GetApproximation()
 {
 	return _approximation;
 }
@@ -260,8 +522,8 @@ ERowVec<T> VariableProjection<T>::GetApproximation()
 *	
 *	Return the weights
 */
-template<typename T>
-EMatrix<T> VariableProjection<T>::GetWeights()
+template<typename T, typename ObserverPolicy>
+EMatrix<T> VariableProjection<T, ObserverPolicy>::GetWeights()
 {
 	return _weights;
 }
@@ -270,8 +532,8 @@ EMatrix<T> VariableProjection<T>::GetWeights()
 *	
 *	Return the measurements.
 */
-template<typename T>
-ERowVec<T> VariableProjection<T>::GetSignal()
+template<typename T, typename ObserverPolicy>
+ERowVec<T> VariableProjection<T, ObserverPolicy>::GetSignal()
 {
 	return _signal;
 }
@@ -280,8 +542,8 @@ ERowVec<T> VariableProjection<T>::GetSignal()
 *	
 *	Return the vector of nonlienar parameters, which act on the function system.
 */
-template<typename T>
-ERowVec<T> VariableProjection<T>::GetNonLinearParameters()
+template<typename T, typename ObserverPolicy>
+ERowVec<T> VariableProjection<T, ObserverPolicy>::GetNonLinearParameters()
 {
 	return _nonLinParams;
 }
@@ -290,8 +552,8 @@ ERowVec<T> VariableProjection<T>::GetNonLinearParameters()
 *	
 *	Return the vector of lienar parameters.
 */
-template<typename T>
-ERowVec<T> VariableProjection<T>::GetLinearParameters()
+template<typename T, typename ObserverPolicy>
+ERowVec<T> VariableProjection<T, ObserverPolicy>::GetLinearParameters()
 {
 	return _linParams;
 }
@@ -300,8 +562,8 @@ ERowVec<T> VariableProjection<T>::GetLinearParameters()
 *	
 *	Set the maximum tolarable error of the optimisation
 */
-template<typename T>
-void VariableProjection<T>::SetMaxErrorForOptimisation(T maxErr)
+template<typename T, typename ObserverPolicy>
+void VariableProjection<T, ObserverPolicy>::SetMaxErrorForOptimisation(T maxErr)
 {
 	_maximumErrorForOptimisation = maxErr;
 }
@@ -310,18 +572,20 @@ void VariableProjection<T>::SetMaxErrorForOptimisation(T maxErr)
 *	
 *	Set the weights
 */
-template<typename T>
-void VariableProjection<T>::SetWeights(EMatrix<T> w)
+template<typename T, typename ObserverPolicy>
+void VariableProjection<T, ObserverPolicy>::SetWeights(EMatrix<T> w)
 {
 	_weights = w;
+	_cache.Clear();
+	invalidateFiniteDifferenceContexts();
 }
 
 /*! \brief SetMaxIterationForOptimisation
 *	
 *	Set the maximum iterations of the optimisation
 */
-template<typename T>
-void VariableProjection<T>::SetMaxIterationForOptimisation(unsigned int maxIteration)
+template<typename T, typename ObserverPolicy>
+void VariableProjection<T, ObserverPolicy>::SetMaxIterationForOptimisation(unsigned int maxIteration)
 {
 	_maximumNumberOfIterationsForOptimisation = maxIteration;
 }
@@ -330,20 +594,24 @@ void VariableProjection<T>::SetMaxIterationForOptimisation(unsigned int maxItera
 *	
 *	Set the measurement to be approximated
 */
-template<typename T>
-void VariableProjection<T>::SetSignal(ERowVec<T> signal)
+template<typename T, typename ObserverPolicy>
+void VariableProjection<T, ObserverPolicy>::SetSignal(ERowVec<T> signal)
 {
     _signal = signal;
+	_cache.Clear();
+	invalidateFiniteDifferenceContexts();
 }
 
 /*! \brief SetFunctionSystem
 *	
 *	Sets the base functions
 */
-template<typename T>
-void VariableProjection<T>::SetFunctionSystem(FunctionSystemDerivative<T>* functionSystem)
+template<typename T, typename ObserverPolicy>
+void VariableProjection<T, ObserverPolicy>::SetFunctionSystem(FunctionSystemDerivative<T>* functionSystem)
 {
     _functionSystem = functionSystem;
+	_cache.Clear();
+	invalidateFiniteDifferenceContexts();
 
 	// Set up default weights
 	int n = _functionSystem->GetFunctionSystem().rows();
@@ -368,8 +636,8 @@ void VariableProjection<T>::SetFunctionSystem(FunctionSystemDerivative<T>* funct
 *	
 *	Sets the optimiser algorithm for the nonLinearParameters
 */
-template<typename T>
-void VariableProjection<T>::SetOptimiser(IApproxStrategy<T, IOptimazible<T> >* approximationStrategy)
+template<typename T, typename ObserverPolicy>
+void VariableProjection<T, ObserverPolicy>::SetOptimiser(IApproxStrategy<T, VariableProjection<T, ObserverPolicy>* >* approximationStrategy)
 {
     _approximationStrategy = approximationStrategy;
 }
@@ -379,32 +647,131 @@ void VariableProjection<T>::SetOptimiser(IApproxStrategy<T, IOptimazible<T> >* a
 *	Starts the approximation algorithm. It first checks the input,
 *	then proceeds with the varpro method.
 */
-template<typename T>
-void VariableProjection<T>::Varpro()
+template<typename T, typename ObserverPolicy>
+void VariableProjection<T, ObserverPolicy>::Varpro()
 {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
 	_functionSystem->ApplyNonLinearParameters(_nonLinParams);
 	if (_nonLinParams.size() > 0) //The problem is nonlinear
 	{
 		_approximationStrategy->Optimize(_maximumErrorForOptimisation, _maximumNumberOfIterationsForOptimisation, _initialParamsForOptimiser, this);
 		_nonLinParams = _approximationStrategy->GetPosition();
-		_currentError = _approximationStrategy->GetCurrentError();
+		_stopReason = _approximationStrategy->GetStopReason();
+
+		// The final position has just been evaluated by the strategy, this is normally a cache hit.
+		// A cache hit does not touch the function system, so it is set to the final position.
+		evaluate(_nonLinParams);
+		_functionSystem->ApplyNonLinearParameters(_nonLinParams);
+	}
+	else //The problem is linear
+	{
 		formJacobian();
 	}
+
+	_fitTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*! \brief Varpro
+*
+*	Same as Varpro(), but the optimiser is given as a template parameter (i.e. StaticNelderMead),
+*	so the strategy calls Evaluate directly without any virtual dispatch.
+*/
+template<typename T, typename ObserverPolicy>
+template<typename StaticStrategy>
+void VariableProjection<T, ObserverPolicy>::Varpro(StaticStrategy& strategy)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	_functionSystem->ApplyNonLinearParameters(_nonLinParams);
+	if (_nonLinParams.size() > 0) //The problem is nonlinear
+	{
+		// A rejected input (i.e. not n+1 vertices for the simplex) leaves the parameters as they are
+		if (strategy.Optimize(_maximumErrorForOptimisation, _maximumNumberOfIterationsForOptimisation, _initialParamsForOptimiser, *this))
+		{
+			_nonLinParams = strategy.GetPosition();
+		}
+		_stopReason = strategy.GetStopReason();
+		evaluate(_nonLinParams);
+		_functionSystem->ApplyNonLinearParameters(_nonLinParams);
+	}
 	else //The problem is linear
 	{
 		formJacobian();
 	}
 
-	_functionSystem->ApplyNonLinearParameters(_approximationStrategy->GetPosition());
-	formJacobian();
+	_fitTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*! \brief evaluate
+*
+*	Sets the approximation, the residual, the error, the linear parameters and the
+*	Jacobian for the given nonlinear parameters. Evaluations are memoized in _cache, so
+*	a repeated point does not regenerate the function system. Note that on a cache hit
+*	the function system keeps the state of the last evaluated (non-cached) point; Varpro
+*	applies the final parameters to it when the optimiser returns.
+*/
+template<typename T, typename ObserverPolicy>
+void VariableProjection<T, ObserverPolicy>::evaluate(const ERowVecRef<T>& nonLinParams)
+{
+	const CachedEvaluation<T>* cached = _cache.Lookup(nonLinParams);
+	if (cached != 0)
+	{
+		_currentError = cached->error;
+		_weighedResidual = cached->residual;
+		_linParams = cached->linearParameters;
+		_approximation = cached->approximation;
+		_jacobian = cached->jacobian;
+		return;
+	}
+
+	_functionSystem->ApplyNonLinearParameters(nonLinParams);
+	if (_finiteDifference != 0)
+	{
+		// The thread contexts are cloned lazily, after the signal or the weights changed.
+		// If the function system was replaced by one that can not be cloned, the finite
+		// differences are dropped for good instead of being retried at every evaluation.
+		if (_finiteDifference->GetNumberOfContexts() == 0 && !_finiteDifference->Initialize(*this))
+		{
+			delete _finiteDifference;
+			_finiteDifference = 0;
+		}
+	}
+
+	if (_finiteDifference != 0)
+	{
+		formJacobian(false);
+		_finiteDifference->Compute(nonLinParams, _weighedResidual, _jacobian);
+	}
+	else
+	{
+		formJacobian();
+	}
+
+	// A disabled cache would only discard the copies
+	if (_cache.GetCapacity() == 0)
+	{
+		return;
+	}
+
+	CachedEvaluation<T> evaluation;
+	evaluation.parameters = nonLinParams;
+	evaluation.error = _currentError;
+	evaluation.residual = _weighedResidual;
+	evaluation.linearParameters = _linParams;
+	evaluation.approximation = _approximation;
+	evaluation.jacobian = _jacobian;
+	_cache.Insert(evaluation);
 }
 
 /*! \brief formJacobian
 *
-*	This method calculates the Jacobian, the current error and the linear parameters
+*	This method calculates the Jacobian, the current error and the linear parameters.
+*	If withJacobian is false, only the linear parameters, the approximation, the residual
+*	and the error are updated.
 */
-template<typename T>
-void VariableProjection<T>::formJacobian()
+template<typename T, typename ObserverPolicy>
+void VariableProjection<T, ObserverPolicy>::formJacobian(bool withJacobian)
 {
 	EMatrix<T> funSys = _functionSystem->GetFunctionSystem();
 	EMatrix<T> dPhi = _functionSystem->GetPartialDerivativesFunctionSystem();
@@ -445,7 +812,7 @@ void VariableProjection<T>::formJacobian()
 	
 		_linParams.resize(1,0);
 		_approximation = funSys;
-		_weighedResidual = ((_weights*(_signal - _approximation).transpose()).array().abs()).matrix();
+		_weighedResidual = _weights*(_signal - _approximation).transpose();
 		return;
 	}
 	
@@ -456,9 +823,14 @@ void VariableProjection<T>::formJacobian()
 	_linParams = ((svd.matrixV().block(0, 0, svd.matrixV().rows(), rank)) * ((temp.array() / s.array()).matrix())).transpose();
 	_approximation = funSys * _linParams.transpose();
 	
-	_weighedResidual = ((_weights*(_signal - _approximation).transpose()).array().abs()).matrix();
+	_weighedResidual = _weights*(_signal - _approximation).transpose();
 	_currentError = _weighedResidual.norm();
 
+	if (!withJacobian)
+	{
+		return;
+	}
+
 	// Form the Jacobian
 	EMatrix<T> wdPhi = _weights*_functionSystem->GetPartialDerivativesFunctionSystem();
 	ERowVec<T> wdPhiResid = (wdPhi.transpose() * _weighedResidual.transpose()).transpose();
@@ -551,7 +923,7 @@ void VariableProjection<T>::formJacobian()
 	EMatrix<T> middle = svd.matrixV().block(0,0, svd.matrixV().rows(), rank).transpose();
 	EMatrix<T> end = T2.block(0,0, _linParams.cols(), T2.cols());
 
-	T2 = beg*(middle.transpose()*end);
+	T2 = beg*(middle*end);
 
 	Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>Jac2 = svd.matrixU().block(0,0, svd.matrixU().rows(), rank) * T2;
 	
@@ -561,12 +933,23 @@ void VariableProjection<T>::formJacobian()
 /*! \brief GetJacobian()
 * Returns the jacobian of the error as calculated by formJacobian()
 */
-template<typename T>
-EMatrix<T> VariableProjection<T>::GetJacobian()
+template<typename T, typename ObserverPolicy>
+EMatrix<T> VariableProjection<T, ObserverPolicy>::GetJacobian()
 {
 	return _jacobian;
 }
 
+/*! \brief GetResidual()
+* Returns the weighted residual W(signal - approximation) of the last evaluation.
+* Its norm is the error, GetJacobian() is its derivative with respect to the
+* nonlinear parameters.
+*/
+template<typename T, typename ObserverPolicy>
+ERowVec<T> VariableProjection<T, ObserverPolicy>::GetResidual()
+{
+	return _weighedResidual;
+}
+
 }
 
 #endif
\ No newline at end of file
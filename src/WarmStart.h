@@ -0,0 +1,135 @@
+#ifndef __WARMSTART_H_INCLUDED__
+#define __WARMSTART_H_INCLUDED__
+
+#include "TypeDefs.h"
+#include "FunctionSystemDerivative.h"
+#include "VariableProjection.h"
+
+namespace APPRSDK
+{
+    /*! \brief WarmStart
+    *
+    * Chains the fits of a configured VariableProjection (used by OnlineApproximator and
+    * SequentialFitter): it keeps the cold start parameters and the result of the previous
+    * fit, and runs the optimiser from the initial simplex moved to a warm start. The shape
+    * of the simplex is kept, scaled by the simplex scale; optionally the optimiser also
+    * continues from a previous OptimizerState.
+    */
+    template<typename T>
+    class WarmStart
+    {
+        protected:
+            VariableProjection<T>* _approximator;
+            EMatrix<T> _initialParameters;
+            bool _reuseOptimizerState;
+            T _simplexScale;
+
+            bool _hasPrevious;
+            ERowVec<T> _previous;
+            OptimizerState<T> _previousState;
+
+        public:
+            WarmStart(VariableProjection<T>* approximator, T simplexScale)
+                : _approximator(approximator), _reuseOptimizerState(false), _simplexScale(simplexScale), _hasPrevious(false)
+            {
+
+            }
+
+            /*! \brief SetInitialParameters
+            *
+            * Cold start: the first row is the starting point, the other rows (if any) complete
+            * the initial simplex, as for SetInitalParametersForOptimiser.
+            */
+            void SetInitialParameters(const EMatrix<T>& parameters)
+            {
+                _initialParameters = parameters;
+            }
+
+            /*! \brief SetReuseOptimizerState
+            *
+            * If true, a warm started fit also continues from the given optimiser state (i.e.
+            * the simplex of Nelder-Mead, the damping of Gauss-Newton).
+            */
+            void SetReuseOptimizerState(bool reuse)
+            {
+                _reuseOptimizerState = reuse;
+            }
+
+            /*! \brief SetSimplexScale
+            *
+            * The initial simplex is scaled by this factor around a warm start.
+            */
+            void SetSimplexScale(T scale)
+            {
+                _simplexScale = scale;
+            }
+
+            /*! \brief Reset
+            *
+            * Forgets the previous fit; the next fit starts cold.
+            */
+            void Reset()
+            {
+                _hasPrevious = false;
+                _previousState = OptimizerState<T>();
+            }
+
+            bool HasPrevious()
+            {
+                return _hasPrevious;
+            }
+
+            const ERowVec<T>& GetPrevious()
+            {
+                return _previous;
+            }
+
+            const OptimizerState<T>& GetPreviousState()
+            {
+                return _previousState;
+            }
+
+            /*! \brief SetPrevious
+            *
+            * Stores the result of the last fit, the starting point of the next warm start.
+            */
+            void SetPrevious(const ERowVec<T>& parameters, const OptimizerState<T>& state)
+            {
+                _previous = parameters;
+                _previousState = state;
+                _hasPrevious = true;
+            }
+
+            /*! \brief Fit
+            *
+            * Runs the optimiser from the initial simplex moved to start, cold if start is
+            * empty (or does not match the initial parameters). state is used if the reuse of
+            * the optimiser state is on. Returns false if no initial parameters were set.
+            */
+            bool Fit(const ERowVec<T>& start, const OptimizerState<T>& state)
+            {
+                if (_initialParameters.rows() == 0 || _initialParameters.cols() == 0)
+                {
+                    return false;
+                }
+
+                EMatrix<T> initial = _initialParameters;
+                if (start.cols() == initial.cols())
+                {
+                    initial.rowwise() -= _initialParameters.row(0);
+                    initial *= _simplexScale;
+                    initial.rowwise() += start;
+                    if (_reuseOptimizerState)
+                    {
+                        _approximator->SetOptimizerState(state, false);
+                    }
+                }
+                _approximator->SetNonLinParams(initial.row(0));
+                _approximator->SetInitalParametersForOptimiser(initial);
+                _approximator->Varpro();
+                return true;
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,257 @@
+#ifndef __WFDBREADER_H_INCLUDED__
+#define __WFDBREADER_H_INCLUDED__
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "IRecordReader.h"
+
+namespace APPRSDK
+{
+    /*! \brief WfdbReader
+    *
+    * Streaming reader of PhysioNet WFDB records (i.e. MIT-BIH): the header (.hea) is
+    * parsed, the signal file (.dat) is read block by block. Format 212 (two 12 bit
+    * samples packed into 3 bytes) and format 16 (16 bit little-endian samples) are
+    * supported, with all signals interleaved in one signal file, as in the MIT-BIH
+    * databases. Multi-segment records, skews and differential formats are not supported.
+    *
+    * The packed samples are unpacked into a 16 bit buffer with a scalar loop (3 byte
+    * stride); the de-interleaving and the conversion to physical units
+    * ((adu - baseline) / gain) is one Eigen expression over the whole block.
+    */
+    template<typename T>
+    class WfdbReader : public IRecordReader<T>
+    {
+        protected:
+            std::ifstream _file;
+            std::string _dataFile;
+            unsigned int _format;
+            unsigned long _byteOffset;
+            double _frequency;
+            unsigned long _length;
+            unsigned long _position;
+            std::vector<std::string> _names;
+            EColVec<T> _baseline;
+            EColVec<T> _inverseGain;
+
+            std::vector<unsigned char> _bytes;
+            std::vector<int16_t> _raw;
+            bool _hasPending;
+            int16_t _pending;
+
+            static int16_t signExtend12(int value)
+            {
+                return (int16_t)(value << 4) >> 4;
+            }
+
+            /*! \brief unpack212
+            *
+            * Unpacks pairs of 12 bit samples: the low 8 bits of the first sample, the high
+            * 4 bits of both samples, the low 8 bits of the second sample.
+            */
+            static void unpack212(const unsigned char* bytes, unsigned long pairs, int16_t* samples)
+            {
+                for (unsigned long i = 0; i < pairs; ++i)
+                {
+                    const unsigned char* b = bytes + 3 * i;
+                    samples[2 * i] = signExtend12(b[0] | ((b[1] & 0x0F) << 8));
+                    samples[2 * i + 1] = signExtend12(b[2] | ((b[1] & 0xF0) << 4));
+                }
+            }
+
+            /*! \brief readSamples
+            *
+            * Reads count interleaved samples into _raw, returns the number read.
+            */
+            unsigned long readSamples(unsigned long count)
+            {
+                _raw.resize(count);
+                if (_format == 16)
+                {
+                    _file.read(reinterpret_cast<char*>(_raw.data()), count * sizeof(int16_t));
+                    unsigned long read = _file.gcount() / sizeof(int16_t);
+                    littleEndianToHost(_raw.data(), read);
+                    return read;
+                }
+
+                unsigned long read = 0;
+                if (_hasPending && count > 0)
+                {
+                    _raw[read++] = _pending;
+                    _hasPending = false;
+                }
+
+                unsigned long pairs = (count - read + 1) / 2;
+                _bytes.resize(3 * pairs);
+                _raw.resize(read + 2 * pairs);
+                _file.read(reinterpret_cast<char*>(_bytes.data()), _bytes.size());
+                pairs = _file.gcount() / 3;
+                unpack212(_bytes.data(), pairs, _raw.data() + read);
+                read += 2 * pairs;
+
+                // The second sample of the last pair belongs to the next block
+                if (read > count)
+                {
+                    _pending = _raw[count];
+                    _hasPending = true;
+                    read = count;
+                }
+                return read;
+            }
+
+        public:
+            WfdbReader() : _format(0), _byteOffset(0), _frequency(0), _length(0), _position(0), _hasPending(false), _pending(0)
+            {
+
+            }
+
+            /*! \brief Open
+            *
+            * Opens the record by the name of its header file (with or without ".hea").
+            * The signal file is looked up next to the header. Returns false if the header
+            * cannot be parsed or the record is not supported.
+            */
+            bool Open(const std::string& headerFile)
+            {
+                std::string header = headerFile;
+                if (header.size() < 4 || header.compare(header.size() - 4, 4, ".hea") != 0)
+                {
+                    header += ".hea";
+                }
+                std::string directory = (header.find_last_of('/') == std::string::npos) ? "" : header.substr(0, header.find_last_of('/') + 1);
+
+                std::ifstream stream(header.c_str());
+                std::vector<std::string> lines;
+                std::string line;
+                while (std::getline(stream, line))
+                {
+                    if (!line.empty() && line[line.size() - 1] == '\r')
+                    {
+                        line.erase(line.size() - 1);
+                    }
+                    if (!line.empty() && line[0] != '#')
+                    {
+                        lines.push_back(line);
+                    }
+                }
+                if (lines.empty())
+                {
+                    return false;
+                }
+
+                // Record line: name, number of signals, sampling frequency, number of samples
+                std::istringstream recordLine(lines[0]);
+                std::string name, frequency;
+                unsigned int channels = 0;
+                recordLine >> name >> channels >> frequency;
+                _length = 0;
+                recordLine >> _length;
+                _frequency = frequency.empty() ? 250 : atof(frequency.c_str());
+                if (name.find('/') != std::string::npos || channels == 0 || lines.size() < channels + 1)
+                {
+                    return false;
+                }
+
+                _names.resize(channels);
+                _baseline.resize(channels);
+                _inverseGain.resize(channels);
+                for (unsigned int c = 0; c < channels; ++c)
+                {
+                    // Signal line: file, format[+offset], gain[(baseline)][/units], resolution, zero, initial value, checksum, block size, description
+                    std::istringstream signalLine(lines[c + 1]);
+                    std::string file, format, gain;
+                    int resolution = 0, zero = 0, initial, checksum, blockSize;
+                    signalLine >> file >> format >> gain >> resolution >> zero >> initial >> checksum >> blockSize;
+                    std::getline(signalLine >> std::ws, _names[c]);
+
+                    unsigned int signalFormat = atoi(format.c_str());
+                    unsigned long offset = (format.find('+') == std::string::npos) ? 0 : atol(format.c_str() + format.find('+') + 1);
+                    if (c == 0)
+                    {
+                        _dataFile = directory + file;
+                        _format = signalFormat;
+                        _byteOffset = offset;
+                    }
+                    if ((directory + file) != _dataFile || signalFormat != _format || offset != _byteOffset || format.find_first_of(":x") != std::string::npos)
+                    {
+                        return false;
+                    }
+
+                    char* end;
+                    double adcGain = gain.empty() ? 0 : strtod(gain.c_str(), &end);
+                    double baseline = (!gain.empty() && *end == '(') ? atof(end + 1) : zero;
+                    adcGain = (adcGain == 0) ? 200 : adcGain;
+                    _baseline(c) = (T)baseline;
+                    _inverseGain(c) = (T)(1.0 / adcGain);
+                }
+
+                return (_format == 212 || _format == 16) && Rewind();
+            }
+
+            unsigned int GetNumberOfChannels()
+            {
+                return _names.size();
+            }
+
+            std::string GetChannelName(unsigned int channel)
+            {
+                return _names[channel];
+            }
+
+            double GetSamplingFrequency()
+            {
+                return _frequency;
+            }
+
+            unsigned long GetLength()
+            {
+                return _length;
+            }
+
+            unsigned long ReadBlock(ERowMajorMatrix<T>& block, unsigned long maxLength)
+            {
+                unsigned long channels = _names.size();
+                unsigned long frames = maxLength;
+                if (_length > 0)
+                {
+                    frames = (_position >= _length) ? 0 : std::min(frames, _length - _position);
+                }
+                if (channels == 0 || !_file.is_open() || frames == 0)
+                {
+                    return 0;
+                }
+
+                frames = readSamples(frames * channels) / channels;
+                if (frames == 0)
+                {
+                    return 0;
+                }
+
+                // The raw samples are frames x channels interleaved, i.e. a column-major channels x frames matrix
+                Eigen::Map<const Eigen::Matrix<int16_t, Eigen::Dynamic, Eigen::Dynamic> > raw(_raw.data(), channels, frames);
+                block.resize(channels, frames);
+                block = ((raw.cast<T>().colwise() - _baseline).array().colwise() * _inverseGain.array()).matrix();
+
+                _position += frames;
+                return frames;
+            }
+
+            bool Rewind()
+            {
+                _file.close();
+                _file.clear();
+                _file.open(_dataFile.c_str(), std::ios::binary);
+                _file.seekg(_byteOffset);
+                _position = 0;
+                _hasPending = false;
+                return _file.good();
+            }
+    };
+}
+
+#endif
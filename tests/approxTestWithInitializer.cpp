@@ -0,0 +1,50 @@
+#include <iostream>
+#include <Eigen/Dense>
+#include "OrthonormalHermite.h"
+#include "NelderMead.h"
+#include "VariableProjection.h"
+#include "CrossCorrelationInitializer.h"
+#include "SignalLoader.h"
+
+using namespace std;
+
+int main()
+{
+    Eigen::RowVectorXd signal;
+    APPRSDK::SignalLoader<double> loader;
+    if (!loader.LoadText("ecg.txt", signal))
+    {
+        cout<<"ecg.txt could not be loaded"<<endl;
+        return 1;
+    }
+    cout<<"Number of samples: "<<signal.cols()<<endl;
+
+    APPRSDK::VariableProjection<double> approximator;
+    APPRSDK::OrthonormalHermite<double> hermiteSys(signal.cols(), 7);
+    APPRSDK::CrossCorrelationInitializer<double> initializer;
+
+    Eigen::RowVectorXd lb(2);
+    lb << 0.01, 0;
+    Eigen::RowVectorXd ub(2);
+    ub << 10, signal.cols();
+
+    approximator.SetMaxErrorForOptimisation(0.01);
+    approximator.SetMaxIterationForOptimisation(100);
+    approximator.SetFunctionSystem(&hermiteSys);
+    approximator.SelectOptimiser(APPRSDK::AvailableOptimizers::NM);
+    approximator.SetBoundaries(lb, ub);
+    approximator.SetSignal(signal);
+
+    Eigen::RowVectorXd estimate = initializer.Estimate(signal, &hermiteSys);
+    initializer.Apply(&approximator, 3);
+    cout<<"Estimated dilatation & translation: "<<estimate<<endl;
+    cout<<"Captured energy: "<<initializer.GetScore()<<" of "<<signal.squaredNorm()<<endl;
+
+    approximator.Varpro();
+
+    cout<<"Dilatation & Translation: "<<approximator.GetNonLinearParameters()<<endl;
+    cout<<"Iterations: "<<approximator.GetIterations()<<endl;
+    cout<<"Final error: "<<approximator.GetError()<<endl;
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <unistd.h>
+#include <Eigen/Dense>
+#include "OrthonormalHermite.h"
+#include "OrthonormalHermiteBatch.h"
+#include "BatchedVariableProjection.h"
+#include "VariableProjection.h"
+
+using namespace std;
+
+int main()
+{
+    const unsigned int shortSleep = 1000;
+    const unsigned int m = 100;
+    const unsigned int n = 6;
+    const int lanes = 4;
+    const int numberOfProblems = 10;
+
+    cout<<"Comparing the batched Hermite system with OrthonormalHermite..."<<endl;
+    usleep(shortSleep);
+
+    APPRSDK::OrthonormalHermite<double> hermiteSys(m, n);
+    APPRSDK::OrthonormalHermiteBatch<double, lanes> hermiteBatch(m, n);
+
+    Eigen::Array<double, lanes, 1> dilatation;
+    Eigen::Array<double, lanes, 1> translation;
+    dilatation << 0.2, 0.5, 0.7, 1.0;
+    translation << 30, 50, 55.5, 70;
+    hermiteBatch.ApplyNonLinearParameters(dilatation, translation);
+
+    for (int l = 0; l < lanes; ++l)
+    {
+        Eigen::RowVectorXd params(2);
+        params << dilatation(l), translation(l);
+        hermiteSys.ApplyNonLinearParameters(params);
+        cout<<"Lane "<<l<<" maximal difference: "<<(hermiteSys.GetFunctionSystem() - hermiteBatch.GetFunctionSystem(l)).cwiseAbs().maxCoeff()<<endl;
+    }
+
+    cout<<"Fitting "<<numberOfProblems<<" synthetic signals in batches of "<<lanes<<"..."<<endl;
+    usleep(shortSleep);
+
+    Eigen::MatrixXd signals(numberOfProblems, m);
+    Eigen::MatrixXd expected(numberOfProblems, 2);
+    for (int i = 0; i < numberOfProblems; ++i)
+    {
+        Eigen::RowVectorXd params(2);
+        params << 0.4 + 0.02*i, 47 + 0.5*i;
+        expected.row(i) = params;
+        hermiteSys.ApplyNonLinearParameters(params);
+        Eigen::VectorXd coeffs = Eigen::VectorXd::Zero(n);
+        coeffs(0) = 1.0;
+        coeffs(2) = 0.5 - 0.05*i;
+        signals.row(i) = (hermiteSys.GetFunctionSystem() * coeffs).transpose();
+    }
+
+    Eigen::MatrixXd initialParameters(1, 2);
+    initialParameters << 0.45, 50;
+
+    APPRSDK::BatchedVariableProjection<double, lanes> batchedApproximator(m, n);
+    batchedApproximator.SetMaxErrorForOptimisation(1e-8);
+    batchedApproximator.SetMaxIterationForOptimisation(200);
+
+    Eigen::MatrixXd nonLinearParameters;
+    Eigen::MatrixXd linearParameters;
+    Eigen::VectorXd errors;
+    batchedApproximator.Fit(signals, initialParameters, nonLinearParameters, linearParameters, errors);
+
+    for (int i = 0; i < numberOfProblems; ++i)
+    {
+        cout<<"Problem "<<i<<": expected "<<expected.row(i)<<", found "<<nonLinearParameters.row(i)<<", error "<<errors(i)<<endl;
+    }
+    cout<<"Batched evaluations: "<<batchedApproximator.GetNumberOfBatchedEvaluations()<<endl;
+
+    cout<<"Comparing the error of problem 0 with VariableProjection at the found parameters..."<<endl;
+    APPRSDK::VariableProjection<double> approximator;
+    approximator.SetFunctionSystem(&hermiteSys);
+    approximator.SetSignal(signals.row(0));
+    Eigen::RowVectorXd found = nonLinearParameters.row(0);
+    cout<<"VariableProjection error: "<<approximator.Evaluate(found)<<", batched error: "<<errors(0)<<endl;
+
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <Eigen/Dense>
+#include "OrthonormalHermite.h"
+#include "NelderMead.h"
+#include "VariableProjection.h"
+#include "BeatSegmenter.h"
+
+using namespace std;
+
+const double frequency = 360;
+const unsigned int m = 200;
+
+double wave(double t, double center, double width, double amplitude)
+{
+    return amplitude * exp(-(t - center) * (t - center) / (2 * width * width));
+}
+
+// Synthetic ECG: P, QRS and T waves with a varying RR interval, baseline wander and noise
+Eigen::RowVectorXd syntheticEcg(double seconds, vector<unsigned long>& peaks)
+{
+    Eigen::RowVectorXd ecg = Eigen::RowVectorXd::Random((long)(seconds * frequency)) * 0.03;
+    srand(1);
+    for (double r = 0.5; r < seconds - 0.5; r += 0.7 + 0.4 * rand() / RAND_MAX)
+    {
+        peaks.push_back((unsigned long)(r * frequency + 0.5));
+        long from = (long)((r - 0.4) * frequency);
+        long to = std::min<long>((long)((r + 0.6) * frequency), ecg.cols());
+        for (long i = std::max<long>(from, 0); i < to; ++i)
+        {
+            double t = i / frequency;
+            ecg(i) += wave(t, r - 0.2, 0.025, 0.15) + wave(t, r - 0.025, 0.01, -0.15) + wave(t, r, 0.012, 1.2)
+                    + wave(t, r + 0.025, 0.01, -0.25) + wave(t, r + 0.3, 0.05, 0.3);
+        }
+    }
+    for (long i = 0; i < ecg.cols(); ++i)
+    {
+        ecg(i) += 0.2 * sin(2 * M_PI * 0.3 * i / frequency);
+    }
+    return ecg;
+}
+
+// VarPro worker: fits the beats of the queue with a Hermite system, starting at the estimated translation
+void fitBeats(APPRSDK::BoundedQueue<APPRSDK::Beat<double> >* queue, unsigned int* fitted, double* totalError)
+{
+    APPRSDK::VariableProjection<double> approximator;
+    APPRSDK::OrthonormalHermite<double> hermiteSys(m, 7);
+    Eigen::RowVectorXd lb(2), ub(2);
+    lb << 0.01, 0;
+    ub << 10, m;
+    approximator.SetMaxErrorForOptimisation(0.001);
+    approximator.SetMaxIterationForOptimisation(100);
+    approximator.SetFunctionSystem(&hermiteSys);
+    approximator.SelectOptimiser(APPRSDK::AvailableOptimizers::NM);
+    approximator.SetBoundaries(lb, ub);
+
+    APPRSDK::Beat<double> beat;
+    while (queue->Pop(beat))
+    {
+        Eigen::RowVectorXd start(2);
+        start << 0.1, beat.translation;
+        Eigen::MatrixXd simplex(3, 2);
+        simplex << 0.1, beat.translation, 0.15, beat.translation, 0.1, beat.translation + 5;
+
+        approximator.SetSignal(beat.window);
+        approximator.SetNonLinParams(start);
+        approximator.SetInitalParametersForOptimiser(simplex);
+        approximator.Varpro();
+
+        (*fitted)++;
+        *totalError += approximator.GetError();
+    }
+}
+
+int main()
+{
+    vector<unsigned long> peaks;
+    Eigen::RowVectorXd ecg = syntheticEcg(60, peaks);
+
+    APPRSDK::BoundedQueue<APPRSDK::Beat<double> > queue(16);
+    APPRSDK::BeatSegmenter<double> segmenter(&queue, m, frequency);
+
+    const unsigned int workers = 2;
+    vector<unsigned int> fitted(workers, 0);
+    vector<double> errors(workers, 0);
+    vector<thread> threads;
+    for (unsigned int w = 0; w < workers; ++w)
+    {
+        threads.push_back(thread(fitBeats, &queue, &fitted[w], &errors[w]));
+    }
+
+    // One pass over the record, in blocks as a reader delivers them
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ecg.cols(); i += 1000)
+    {
+        segmenter.Push(ecg.segment(i, std::min<long>(1000, ecg.cols() - i)));
+    }
+    segmenter.Finish();
+    for (unsigned int w = 0; w < workers; ++w)
+    {
+        threads[w].join();
+    }
+    double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // The detections are compared with the true R peaks (the first 2 s are used for learning)
+    APPRSDK::PanTompkinsDetector<double> detector(frequency);
+    unsigned int expected = 0, found = 0, falsePositives = 0;
+    double maxOffset = 0;
+    vector<bool> matched(peaks.size(), false);
+    for (long i = 0; i < ecg.cols(); ++i)
+    {
+        if (!detector.Push(ecg(i)))
+        {
+            continue;
+        }
+        unsigned long peak = detector.GetPeak();
+        bool match = false;
+        for (unsigned int p = 0; p < peaks.size(); ++p)
+        {
+            double offset = fabs((double)peak - (double)peaks[p]);
+            if (!matched[p] && offset <= 0.05 * frequency)
+            {
+                matched[p] = match = true;
+                maxOffset = max(maxOffset, offset / frequency);
+                break;
+            }
+        }
+        found += match;
+        falsePositives += !match;
+    }
+    for (unsigned int p = 0; p < peaks.size(); ++p)
+    {
+        expected += (peaks[p] > 2.2 * frequency);
+    }
+
+    cout << "true beats (after learning): " << expected << ", detected: " << found << ", false detections: " << falsePositives
+         << ", max offset: " << maxOffset * 1000 << " ms" << endl;
+    cout << "beats emitted: " << segmenter.GetNumberOfBeats() << ", dropped: " << segmenter.GetNumberOfDroppedBeats() << endl;
+    for (unsigned int w = 0; w < workers; ++w)
+    {
+        cout << "worker " << w << ": " << fitted[w] << " beats, mean error: " << (fitted[w] ? errors[w] / fitted[w] : 0) << endl;
+    }
+    cout << "segmentation and fitting: " << time << " s for " << ecg.cols() / frequency << " s of signal" << endl;
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <Eigen/Dense>
+#include "OrthonormalHermite.h"
+#include "NelderMead.h"
+#include "VariableProjection.h"
+#include "CrossCorrelationInitializer.h"
+#include "SignalLoader.h"
+#include "CoefficientStore.h"
+
+using namespace std;
+
+// Test model of a beat: degree 5 to 7, coefficients and parameters derived from the beat number
+template<typename T>
+void testModel(unsigned long beat, Eigen::Matrix<T, 1, Eigen::Dynamic>& linear, Eigen::Matrix<T, 1, Eigen::Dynamic>& nonLinear)
+{
+    linear.resize(5 + beat % 3);
+    for (long k = 0; k < linear.cols(); ++k)
+    {
+        linear(k) = (T)sin(beat * 0.1 + k);
+    }
+    nonLinear.resize(2);
+    nonLinear << (T)(0.05 + (beat % 10) * 0.001), (T)(150 + beat % 7);
+}
+
+template<typename T>
+void testStore(const char* filename, unsigned long beats, unsigned int blockSize)
+{
+    Eigen::Matrix<T, 1, Eigen::Dynamic> linear, nonLinear;
+    APPRSDK::CoefficientWriter<T> writer;
+    writer.Open(filename, 7, 2, blockSize);
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long beat = 0; beat < beats; ++beat)
+    {
+        testModel(beat, linear, nonLinear);
+        writer.Append(beat * 300, linear, nonLinear, (T)(beat % 100) / 10);
+    }
+    bool ok = writer.Close();
+    double writeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    APPRSDK::CoefficientReader<T> reader;
+    ok = reader.Open(filename) && ok;
+    cout << "sample size " << sizeof(T) << ", block size " << blockSize << ": " << (ok ? "written and opened" : "failed") << ", beats: "
+         << reader.GetNumberOfBeats() << ", blocks: " << reader.GetNumberOfBlocks() << ", write time: " << writeTime << " s" << endl;
+
+    // Random access
+    const unsigned long lookups = 1000000;
+    APPRSDK::CoefficientRecord<T> record;
+    double deviation = 0;
+    unsigned long mismatches = 0;
+    srand(1);
+    start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < lookups; ++i)
+    {
+        unsigned long beat = (unsigned long)rand() % beats;
+        reader.Get(beat, record);
+        testModel(beat, linear, nonLinear);
+        mismatches += (record.timestamp != beat * 300 || record.degree != linear.cols() || record.prd != (T)(beat % 100) / 10);
+        deviation = max(deviation, (double)((record.linearParameters - linear).cwiseAbs().maxCoeff()));
+        deviation = max(deviation, (double)((record.nonLinearParameters - nonLinear).cwiseAbs().maxCoeff()));
+    }
+    double lookupTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    cout << "random access: " << lookups << " beats in " << lookupTime << " s, mismatches: " << mismatches << ", max deviation: " << deviation << endl;
+
+    // Timestamps
+    cout << "beat at timestamp 300000: " << reader.FindBeat(300000) << ", at 300001: " << reader.FindBeat(300001)
+         << ", after the end: " << reader.FindBeat(beats * 300) << endl;
+    remove(filename);
+}
+
+// Writes a file of 3 blocks, overwrites the value at the given position (from the end if
+// negative) and tries to open it
+template<typename Value>
+bool openCorrupted(const char* filename, long position, Value value)
+{
+    Eigen::Matrix<double, 1, Eigen::Dynamic> linear, nonLinear;
+    APPRSDK::CoefficientWriter<double> writer;
+    writer.Open(filename, 7, 2, 100);
+    for (unsigned long beat = 0; beat < 250; ++beat)
+    {
+        testModel(beat, linear, nonLinear);
+        writer.Append(beat * 300, linear, nonLinear, 0.0);
+    }
+    writer.Close();
+
+    fstream file(filename, ios::in | ios::out | ios::binary);
+    file.seekp(position, position < 0 ? ios::end : ios::beg);
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    file.close();
+
+    APPRSDK::CoefficientReader<double> reader;
+    bool ok = reader.Open(filename);
+    remove(filename);
+    return ok;
+}
+
+int main()
+{
+    testStore<double>("/tmp/coefficientStore.bin", 300000, 4096);
+    testStore<float>("/tmp/coefficientStore.bin", 10001, 1001);
+
+    // Corrupted files: the index of the 3 blocks is followed by the footer
+    const char* corrupted = "/tmp/coefficientStoreCorrupted.bin";
+    const long entry = sizeof(APPRSDK::CoefficientBlockIndex);
+    const long index = -(3 * entry + (long)sizeof(APPRSDK::CoefficientFileFooter));
+    cout << "opened: intact " << openCorrupted(corrupted, index, (uint64_t)32)
+         << ", version 2 " << openCorrupted(corrupted, offsetof(APPRSDK::CoefficientFileHeader, version), (uint32_t)2)
+         << ", block past the index " << openCorrupted(corrupted, index + 2 * entry + (long)offsetof(APPRSDK::CoefficientBlockIndex, offset), (uint64_t)1 << 40)
+         << ", wrong first beat " << openCorrupted(corrupted, index + entry + (long)offsetof(APPRSDK::CoefficientBlockIndex, firstBeat), (uint64_t)99)
+         << ", short middle block " << openCorrupted(corrupted, index + entry + (long)offsetof(APPRSDK::CoefficientBlockIndex, numberOfBeats), (uint64_t)99)
+         << ", oversized last block " << openCorrupted(corrupted, index + 2 * entry + (long)offsetof(APPRSDK::CoefficientBlockIndex, numberOfBeats), (uint64_t)100000)
+         << endl;
+
+    // The result of an approximation
+    Eigen::RowVectorXd signal;
+    APPRSDK::SignalLoader<double> loader;
+    loader.LoadText("ecg.txt", signal);
+
+    APPRSDK::VariableProjection<double> approximator;
+    APPRSDK::OrthonormalHermite<double> hermiteSys(signal.cols(), 7);
+    APPRSDK::CrossCorrelationInitializer<double> initializer;
+    Eigen::RowVectorXd lb(2), ub(2);
+    lb << 0.01, 0;
+    ub << 10, signal.cols();
+    approximator.SetMaxIterationForOptimisation(100);
+    approximator.SetFunctionSystem(&hermiteSys);
+    approximator.SelectOptimiser(APPRSDK::AvailableOptimizers::NM);
+    approximator.SetBoundaries(lb, ub);
+    approximator.SetSignal(signal);
+    initializer.Estimate(signal, &hermiteSys);
+    initializer.Apply(&approximator, 3);
+    approximator.Varpro();
+
+    APPRSDK::CoefficientWriter<double> writer;
+    writer.Open("/tmp/coefficientStore.bin", 7, 2);
+    writer.Append(0, approximator);
+    writer.Close();
+
+    APPRSDK::CoefficientReader<double> reader;
+    APPRSDK::CoefficientRecord<double> record;
+    reader.Open("/tmp/coefficientStore.bin");
+    reader.Get(0, record);
+    cout << "stored model: degree " << record.degree << ", PRD " << record.prd << " %, parameters " << record.nonLinearParameters
+         << ", coefficients equal: " << (record.linearParameters == approximator.GetLinearParameters()) << endl;
+    reader.Close();
+    remove("/tmp/coefficientStore.bin");
+
+    return 0;
+}
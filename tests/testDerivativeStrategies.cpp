@@ -0,0 +1,39 @@
+#include <iostream>
+#include <Eigen/Dense>
+#include "OrthonormalHermite.h"
+#include "VariableProjection.h"
+
+using namespace std;
+
+int main()
+{
+    APPRSDK::AvailableOptimizers strategies[] = {APPRSDK::AvailableOptimizers::GN, APPRSDK::AvailableOptimizers::DL, APPRSDK::AvailableOptimizers::LBFGS};
+    const char* names[] = {"Gauss-Newton", "dogleg", "L-BFGS"};
+    const int numberOfStrategies = 3;
+
+    Eigen::RowVectorXd inputParameters(2);
+    inputParameters << 0.7, 50;
+    Eigen::RowVectorXd lb(2), ub(2);
+    lb << 0.01, -1000;
+    ub << 1000, 1000;
+
+    for (int i = 0; i < numberOfStrategies; ++i)
+    {
+        APPRSDK::VariableProjection<double> approximator;
+        APPRSDK::OrthonormalHermite<double> hermiteSys(100, 10);
+        approximator.SetMaxErrorForOptimisation(0.01);
+        approximator.SetMaxIterationForOptimisation(100);
+        approximator.SetFunctionSystem(&hermiteSys);
+        approximator.SetSignal(hermiteSys.GetFunctionSystem().col(4).transpose());
+        approximator.SetNonLinParams(inputParameters);
+        approximator.SelectOptimiser(strategies[i], true);
+        approximator.SetBoundaries(lb, ub);
+        approximator.Varpro();
+
+        cout<<names[i]<<": dilatation & translation "<<approximator.GetNonLinearParameters()<<", final error "<<approximator.GetError()
+            <<", stop reason "<<approximator.GetStopReason()<<endl;
+        cout<<"evaluations: "<<approximator.GetIterations()<<", fit time: "<<approximator.GetFitTime()<<" s"<<endl;
+    }
+
+    return 0;
+}
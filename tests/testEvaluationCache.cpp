@@ -0,0 +1,60 @@
+#include <iostream>
+#include <chrono>
+#include <Eigen/Dense>
+#include "OrthonormalHermite.h"
+#include "NelderMead.h"
+#include "VariableProjection.h"
+
+using namespace std;
+
+int main()
+{
+    APPRSDK::VariableProjection<double> approximator;
+    APPRSDK::OrthonormalHermite<double> hermiteSys(100, 10);
+
+    Eigen::RowVectorXd inputParameters(2);
+    inputParameters << 0.7, 50;
+    Eigen::RowVectorXd lb(2), ub(2);
+    lb << 0.01, -1000;
+    ub << 1000, 1000;
+
+    approximator.SetMaxErrorForOptimisation(0.01);
+    approximator.SetMaxIterationForOptimisation(100);
+    approximator.SetFunctionSystem(&hermiteSys);
+    approximator.SetNonLinParams(inputParameters);
+    approximator.SelectOptimiser(APPRSDK::AvailableOptimizers::NM, true);
+    approximator.SetBoundaries(lb, ub);
+    approximator.SetSignal(hermiteSys.GetFunctionSystem().col(4).transpose());
+
+    unsigned int capacities[] = {0, 64};
+    for (int i = 0; i < 2; ++i)
+    {
+        approximator.SetCacheOptions(capacities[i], 0);
+        approximator.SetNonLinParams(inputParameters);
+        unsigned int evaluations = approximator.GetIterations();
+        approximator.Varpro();
+
+        cout<<"cache capacity "<<capacities[i]<<": dilatation & translation "<<approximator.GetNonLinearParameters()<<", final error "<<approximator.GetError()
+            <<", evaluations "<<approximator.GetIterations() - evaluations<<", hit rate "<<approximator.GetCacheHitRate()<<endl;
+
+        // The last evaluation is a cache hit, but the function system has to be at the final parameters
+        cout<<"deviation of the function system at the final parameters from the approximation: "
+            <<((hermiteSys.GetFunctionSystem() * approximator.GetLinearParameters().transpose()).transpose() - approximator.GetApproximation()).norm()<<endl;
+    }
+
+    // The same fit from an empty cache, repeated for a stable time
+    const int fits = 100;
+    for (int i = 0; i < 2; ++i)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int k = 0; k < fits; ++k)
+        {
+            approximator.SetCacheOptions(capacities[i], 0);
+            approximator.SetNonLinParams(inputParameters);
+            approximator.Varpro();
+        }
+        cout<<"cache capacity "<<capacities[i]<<": time per fit "<<std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / fits<<" s"<<endl;
+    }
+
+    return 0;
+}
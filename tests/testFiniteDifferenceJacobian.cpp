@@ -0,0 +1,96 @@
+#include <iostream>
+#include <chrono>
+#include <Eigen/Dense>
+#include "OrthonormalHermite.h"
+#include "VariableProjection.h"
+
+using namespace std;
+
+// A function system that can not be copied, so it can not be differentiated numerically
+class UncloneableHermite : public APPRSDK::OrthonormalHermite<double>
+{
+    public:
+        UncloneableHermite(unsigned int numberOfValues, unsigned int degree) : APPRSDK::OrthonormalHermite<double>(numberOfValues, degree)
+        {
+
+        }
+
+        APPRSDK::FunctionSystemDerivative<double>* Clone()
+        {
+            return 0;
+        }
+};
+
+int main()
+{
+    APPRSDK::OrthonormalHermite<double> hermiteSys(100, 10);
+    APPRSDK::OrthonormalHermite<double> signalSys(100, 10);
+
+    Eigen::RowVectorXd signalParameters;
+    signalParameters.resize(2);
+    signalParameters(0) = 0.35;
+    signalParameters(1) = 47;
+    signalSys.ApplyNonLinearParameters(signalParameters);
+
+    Eigen::RowVectorXd signal = signalSys.GetFunctionSystem().col(3).transpose() + 0.3*signalSys.GetFunctionSystem().col(6).transpose();
+
+    Eigen::RowVectorXd position;
+    position.resize(2);
+    position(0) = 0.3;
+    position(1) = 45;
+
+    APPRSDK::VariableProjection<double> approximator;
+    approximator.SetNonLinParams(position);
+    approximator.SetFunctionSystem(&hermiteSys);
+    approximator.SetSignal(signal);
+    approximator.SetCacheOptions(0, 0);
+
+    approximator.Evaluate(position);
+    Eigen::MatrixXd analytic = approximator.GetJacobian();
+
+    APPRSDK::FiniteDifferenceScheme schemes[] = {APPRSDK::ForwardDifference, APPRSDK::CentralDifference};
+    const char* schemeNames[] = {"forward", "central"};
+    unsigned int threads[] = {1, 4};
+
+    for (int i = 0; i < 2; ++i)
+    {
+        for (int j = 0; j < 2; ++j)
+        {
+            if (!approximator.SetFiniteDifferenceJacobian(schemes[i], threads[j]))
+            {
+                cout<<"finite differences could not be set up"<<endl;
+                continue;
+            }
+
+            // The first evaluation clones the contexts, the following ones reuse them
+            approximator.Evaluate(position);
+            Eigen::MatrixXd numeric = approximator.GetJacobian();
+
+            const int evaluations = 1000;
+            Eigen::RowVectorXd shifted = position;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (int k = 0; k < evaluations; ++k)
+            {
+                shifted(1) = position(1) + k * 1e-3;
+                approximator.Evaluate(shifted);
+            }
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / evaluations;
+
+            cout<<schemeNames[i]<<" differences, "<<threads[j]<<" thread(s): max. deviation from the analytic Jacobian "
+                <<(numeric - analytic).cwiseAbs().maxCoeff()<<" (norm of the analytic Jacobian "<<analytic.norm()<<"), "
+                <<elapsed<<" s per evaluation"<<endl;
+        }
+    }
+
+    UncloneableHermite uncloneableSys(100, 10);
+    APPRSDK::VariableProjection<double> uncloneable;
+    uncloneable.SetNonLinParams(position);
+    uncloneable.SetFunctionSystem(&uncloneableSys);
+    uncloneable.SetSignal(signal);
+    bool enabled = uncloneable.SetFiniteDifferenceJacobian(APPRSDK::CentralDifference);
+    uncloneable.Evaluate(position);
+    cout<<"function system without Clone: finite differences "<<(enabled ? "enabled" : "refused")<<", Jacobian "
+        <<uncloneable.GetJacobian().rows()<<" x "<<uncloneable.GetJacobian().cols()<<endl;
+
+    return 0;
+}
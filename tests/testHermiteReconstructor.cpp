@@ -0,0 +1,98 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <Eigen/Dense>
+#include "OrthonormalHermite.h"
+#include "HermiteReconstructor.h"
+
+using namespace std;
+
+int main()
+{
+    const unsigned int m = 300;
+    const unsigned int n = 7;
+
+    // A 24 h record at 70 bpm (about 100000 beats) with random models
+    const unsigned long beats = 100800;
+    Eigen::MatrixXd coefficients = Eigen::MatrixXd::Random(beats, n);
+    Eigen::VectorXd dilatation = (Eigen::VectorXd::Random(beats).array() * 0.01 + 0.05).matrix();
+    Eigen::VectorXd translation = (Eigen::VectorXd::Random(beats).array() * 10 + 150).matrix();
+
+    APPRSDK::CoefficientWriter<double> writer;
+    writer.Open("/tmp/hermiteReconstructor.bin", n, 2);
+    for (unsigned long b = 0; b < beats; ++b)
+    {
+        Eigen::RowVectorXd parameters(2);
+        parameters << dilatation(b), translation(b);
+        writer.Append(b * 308, coefficients.row(b), parameters, 0);
+    }
+    writer.Close();
+
+    // Compared with OrthonormalHermite, beat by beat
+    APPRSDK::HermiteReconstructor<double> reconstructor(m, n);
+    Eigen::MatrixXd signals;
+    reconstructor.Reconstruct(coefficients.topRows(1000), dilatation.head(1000), translation.head(1000), signals);
+
+    APPRSDK::OrthonormalHermite<double> hermiteSys(m, n);
+    double deviation = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int b = 0; b < 1000; ++b)
+    {
+        Eigen::RowVectorXd parameters(2);
+        parameters << dilatation(b), translation(b);
+        hermiteSys.ApplyNonLinearParameters(parameters);
+        Eigen::VectorXd beat = hermiteSys.GetFunctionSystem() * coefficients.row(b).transpose();
+        deviation = max(deviation, (beat - signals.col(b)).cwiseAbs().maxCoeff());
+    }
+    double hermiteTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    reconstructor.Reconstruct(coefficients.topRows(1000), dilatation.head(1000), translation.head(1000), signals);
+    double batchTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    cout << "1000 beats: OrthonormalHermite per beat: " << hermiteTime << " s, batched: " << batchTime << " s, max deviation: " << deviation << endl;
+
+    // Shared parameters: one GEMM
+    Eigen::MatrixXd shared;
+    start = std::chrono::steady_clock::now();
+    reconstructor.Reconstruct(coefficients.topRows(1000), dilatation(0), translation(0), shared);
+    double gemmTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    reconstructor.Reconstruct(coefficients.topRows(1000), Eigen::VectorXd::Constant(1000, dilatation(0)), Eigen::VectorXd::Constant(1000, translation(0)), signals);
+    cout << "1000 beats with shared parameters: GEMM: " << gemmTime << " s, max deviation: " << (shared - signals).cwiseAbs().maxCoeff() << endl;
+
+    // Scrubbing through the stored record: the beats of a 10 s view, and the whole record
+    APPRSDK::CoefficientReader<double> reader;
+    reader.Open("/tmp/hermiteReconstructor.bin");
+    start = std::chrono::steady_clock::now();
+    for (unsigned long first = 0; first < beats; first += beats / 100)
+    {
+        reconstructor.Reconstruct(reader, reader.FindBeat(first * 308), 12, signals);
+    }
+    double viewTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / 100;
+
+    start = std::chrono::steady_clock::now();
+    reconstructor.Reconstruct(reader, 0, beats, signals);
+    double recordTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    cout << "view of 12 beats: " << viewTime * 1000 << " ms, whole record (" << signals.cols() << " beats): " << recordTime << " s" << endl;
+
+    APPRSDK::CoefficientBlock<double> block;
+    reader.GetBlock(0, block);
+    bool reconstructed = reconstructor.Reconstruct(block, signals);
+    cout << "first block: " << (reconstructed ? "reconstructed" : "refused") << ", " << signals.cols() << " beats" << endl;
+    reader.Close();
+
+    // A file without the translation cannot be reconstructed, nor can models without coefficients
+    writer.Open("/tmp/hermiteReconstructor.bin", n, 1);
+    writer.Append(0, coefficients.row(0), dilatation.head(1).transpose(), 0);
+    writer.Close();
+    reader.Open("/tmp/hermiteReconstructor.bin");
+    reader.GetBlock(0, block);
+    cout << "block with one nonlinear parameter: " << (reconstructor.Reconstruct(block, signals) ? "reconstructed" : "refused") << endl;
+    reader.Close();
+    remove("/tmp/hermiteReconstructor.bin");
+
+    reconstructor.Reconstruct(coefficients.topRows(3).leftCols(0), dilatation.head(3), translation.head(3), signals);
+    cout << "no coefficients: " << signals.rows() << " x " << signals.cols() << ", max: " << signals.cwiseAbs().maxCoeff() << endl;
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <iostream>
+#include <Eigen/Dense>
+#include "OrthonormalHermite.h"
+#include "VariableProjection.h"
+#include "HybridStrategy.h"
+
+using namespace std;
+
+int main()
+{
+    APPRSDK::VariableProjection<double> approximator;
+    APPRSDK::OrthonormalHermite<double> hermiteSys(100, 10);
+    APPRSDK::HybridStrategy<double, APPRSDK::VariableProjection<double>* > hybridOptimizer;
+
+    Eigen::RowVectorXd inputParameters(2);
+    inputParameters << 0.7, 50;
+    Eigen::RowVectorXd lb(2), ub(2);
+    lb << 0.01, -1000;
+    ub << 1000, 1000;
+    Eigen::MatrixXd simplex(3, 2);
+    simplex << 0.7, 50, 2.2, 51.5, 3.7, 53;
+
+    approximator.SetMaxErrorForOptimisation(1e-6);
+    approximator.SetMaxIterationForOptimisation(100);
+    approximator.SetFunctionSystem(&hermiteSys);
+    approximator.SetOptimiser(&hybridOptimizer);
+    approximator.SetInitalParametersForOptimiser(simplex);
+    approximator.SetBoundaries(lb, ub);
+    approximator.SetSignal(hermiteSys.GetFunctionSystem().col(4).transpose());
+
+    // The budget limits both phases together
+    unsigned int maxEvaluations[] = {0, 60, 25};
+    for (int i = 0; i < 3; ++i)
+    {
+        APPRSDK::OptimizationBudget<double> budget;
+        budget.SetMaxEvaluations(maxEvaluations[i]);
+        approximator.SetBudget(budget);
+        approximator.SetNonLinParams(inputParameters);
+        approximator.Varpro();
+
+        cout<<"evaluation budget "<<maxEvaluations[i]<<" (0: none): dilatation & translation "<<approximator.GetNonLinearParameters()
+            <<", final error "<<approximator.GetError()<<", stop reason "<<approximator.GetStopReason()<<endl;
+        cout<<"evaluations (simplex / local phase): "<<hybridOptimizer.GetSimplexEvaluations()<<" / "<<hybridOptimizer.GetLocalEvaluations()
+            <<", fit time "<<approximator.GetFitTime()<<" s"<<endl;
+    }
+
+    // The iterations limit both phases together as well
+    approximator.SetBudget(APPRSDK::OptimizationBudget<double>());
+    unsigned int maxIterations[] = {100, 30, 10};
+    for (int i = 0; i < 3; ++i)
+    {
+        approximator.SetMaxIterationForOptimisation(maxIterations[i]);
+        approximator.SetNonLinParams(inputParameters);
+        approximator.Varpro();
+        cout<<"max iterations "<<maxIterations[i]<<": iterations "<<hybridOptimizer.GetIterations()<<" (simplex / local phase evaluations: "
+            <<hybridOptimizer.GetSimplexEvaluations()<<" / "<<hybridOptimizer.GetLocalEvaluations()<<"), final error "<<approximator.GetError()
+            <<", stop reason "<<approximator.GetStopReason()<<endl;
+    }
+
+    return 0;
+}
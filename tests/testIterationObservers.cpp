@@ -0,0 +1,51 @@
+#include <iostream>
+#include <Eigen/Dense>
+#include "OrthonormalHermite.h"
+#include "NelderMead.h"
+#include "VariableProjection.h"
+#include "IterationObservers.h"
+
+using namespace std;
+
+// The observers are set at runtime
+typedef APPRSDK::VariableProjection<double, APPRSDK::RuntimeObserverPolicy<double> > ObservedVariableProjection;
+
+int main()
+{
+    ObservedVariableProjection approximator;
+    APPRSDK::OrthonormalHermite<double> hermiteSys(100, 10);
+    APPRSDK::NelderMead<double, ObservedVariableProjection* > optimizer;
+
+    Eigen::RowVectorXd inputParameters(2);
+    inputParameters << 0.7, 50;
+    Eigen::MatrixXd simplex(3, 2);
+    simplex << 0.7, 50, 2.2, 51.5, 3.7, 53;
+
+    approximator.SetMaxErrorForOptimisation(0.01);
+    approximator.SetMaxIterationForOptimisation(100);
+    approximator.SetFunctionSystem(&hermiteSys);
+    approximator.SetOptimiser(&optimizer);
+    approximator.SetInitalParametersForOptimiser(simplex);
+    approximator.SetSignal(hermiteSys.GetFunctionSystem().col(4).transpose());
+
+    APPRSDK::TraceObserver<double> trace(5, APPRSDK::ObserveTiming);
+    APPRSDK::CountingObserver<double> counting;
+
+    approximator.SetObserver(&trace);
+    approximator.SetNonLinParams(inputParameters);
+    approximator.Varpro();
+    cout<<"last evaluations (iteration, error, time, position):"<<endl;
+    trace.Print(cout);
+
+    approximator.SetObserver(&counting);
+    approximator.SetNonLinParams(inputParameters);
+    approximator.Varpro();
+    cout<<"evaluations: "<<counting.GetNumberOfEvaluations()<<", best error "<<counting.GetBestError()<<" in iteration "<<counting.GetBestIteration()<<endl;
+
+    approximator.SetObserver(0);
+    approximator.SetNonLinParams(inputParameters);
+    approximator.Varpro();
+    cout<<"without observer: final error "<<approximator.GetError()<<endl;
+
+    return 0;
+}
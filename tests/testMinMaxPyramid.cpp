@@ -0,0 +1,56 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <Eigen/Dense>
+#include "MinMaxPyramid.h"
+
+using namespace std;
+
+int main()
+{
+    const unsigned int columns = 2000;
+    long lengths[] = {100000, 1000000, 10000000};
+
+    for (int i = 0; i < 3; ++i)
+    {
+        // ECG-like test record: a slow wave, a spike in every 300 samples and noise
+        Eigen::RowVectorXd record = Eigen::RowVectorXd::Random(lengths[i]) * 0.05;
+        for (long j = 0; j < lengths[i]; ++j)
+        {
+            record(j) += sin(j / 500.0) + ((j % 300 == 150) ? 1.0 : 0.0);
+        }
+
+        APPRSDK::MinMaxPyramid<double> pyramid;
+        auto start = std::chrono::steady_clock::now();
+        pyramid.Build(record);
+        double buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        Eigen::RowVectorXd x, y;
+        start = std::chrono::steady_clock::now();
+        pyramid.Envelope(0, lengths[i], columns, x, y);
+        double envelopeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Zooming into the middle tenth of the record
+        Eigen::RowVectorXd xZoom, yZoom;
+        start = std::chrono::steady_clock::now();
+        pyramid.Envelope(lengths[i] * 9 / 20, lengths[i] * 11 / 20, columns, xZoom, yZoom);
+        double zoomTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Compared with the exact min / max of the unaligned pixel columns
+        double deviation = 0;
+        for (unsigned int c = 0; c < columns; ++c)
+        {
+            long from = (long)((double)c * lengths[i] / columns);
+            long to = (long)((double)(c + 1) * lengths[i] / columns);
+            deviation = max(deviation, fabs(record.segment(from, to - from).minCoeff() - y(2 * c)));
+            deviation = max(deviation, fabs(record.segment(from, to - from).maxCoeff() - y(2 * c + 1)));
+        }
+
+        cout << "record length: " << lengths[i] << ", levels: " << pyramid.GetNumberOfLevels() << endl;
+        cout << "build time: " << buildTime << " s" << endl;
+        cout << "envelope time (full record / zoom): " << envelopeTime << " / " << zoomTime << " s, points: " << y.cols() << " / " << yZoom.cols() << endl;
+        cout << "max deviation from the exact envelope: " << deviation << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <Eigen/Dense>
+#include "OrthonormalHermite.h"
+#include "NelderMead.h"
+#include "OnlineApproximator.h"
+
+using namespace std;
+
+const unsigned int m = 100;
+const unsigned int hop = 10;
+
+// Continuous test signal: a wave every 200 samples, with some noise
+Eigen::RowVectorXd continuousSignal(long length)
+{
+    Eigen::RowVectorXd signal = Eigen::RowVectorXd::Random(length) * 0.02;
+    for (long i = 0; i < length; ++i)
+    {
+        double t = (i % 200) - 100.0;
+        signal(i) += exp(-t * t / 50.0) - 0.3 * exp(-(t - 8) * (t - 8) / 20.0);
+    }
+    return signal;
+}
+
+void configure(APPRSDK::VariableProjection<double>& approximator, APPRSDK::OrthonormalHermite<double>& hermiteSys)
+{
+    approximator.SetMaxErrorForOptimisation(0.001);
+    approximator.SetMaxIterationForOptimisation(100);
+    approximator.SetFunctionSystem(&hermiteSys);
+    approximator.SelectOptimiser(APPRSDK::AvailableOptimizers::NM);
+}
+
+void report(const char* name, const vector<APPRSDK::OnlineWindow<double> >& windows)
+{
+    double evaluations = 0, error = 0, latency = 0, maxLatency = 0;
+    for (unsigned int i = 0; i < windows.size(); ++i)
+    {
+        evaluations += windows[i].evaluations;
+        error += windows[i].error;
+        latency += windows[i].latency;
+        maxLatency = max(maxLatency, windows[i].latency);
+    }
+    cout << name << ": windows: " << windows.size() << ", mean evaluations: " << evaluations / windows.size()
+         << ", mean error: " << error / windows.size() << ", latency mean / max: " << latency / windows.size() * 1000
+         << " / " << maxLatency * 1000 << " ms" << endl;
+}
+
+int main()
+{
+    Eigen::RowVectorXd signal = continuousSignal(1600);
+
+    Eigen::RowVectorXd lb(2), ub(2);
+    lb << 0.01, 0;
+    ub << 2, m;
+    Eigen::MatrixXd initial(3, 2);
+    initial << 0.1, m / 2.0, 0.15, m / 2.0, 0.1, m / 2.0 + 5;
+
+    // Every window fitted cold (no warm start, no tracking)
+    APPRSDK::VariableProjection<double> coldApproximator;
+    APPRSDK::OrthonormalHermite<double> coldSystem(m, 7);
+    configure(coldApproximator, coldSystem);
+    APPRSDK::OnlineApproximator<double> cold(&coldApproximator, m, hop);
+    cold.SetInitialParameters(initial);
+    cold.SetBoundaries(lb, ub);
+    cold.SetTranslationIndex(1);
+
+    vector<APPRSDK::OnlineWindow<double> > coldWindows;
+    for (long i = 0; i + hop <= signal.cols(); i += hop)
+    {
+        cold.Reset();
+        cold.Push(signal.segment(max<long>(0, i + hop - m), min<long>(m, i + hop)), &coldWindows);
+    }
+    report("cold", coldWindows);
+
+    // Online mode, warm start only: every window is optimised, starting from the previous one
+    APPRSDK::VariableProjection<double> approximator;
+    APPRSDK::OrthonormalHermite<double> hermiteSys(m, 7);
+    configure(approximator, hermiteSys);
+    APPRSDK::OnlineApproximator<double> online(&approximator, m, hop);
+    online.SetInitialParameters(initial);
+    online.SetBoundaries(lb, ub);
+
+    vector<APPRSDK::OnlineWindow<double> > windows;
+    APPRSDK::OnlineApproximator<double> unconfigured(&coldApproximator, m, hop);
+    cout << "windows without initial parameters: " << unconfigured.Push(signal, &windows) << endl;
+    online.Push(signal, &windows);
+    report("warm start only", windows);
+
+    // Online mode with tracking: a moved fit with at most the running mean error of the optimised windows is not optimised
+    online.Reset();
+    online.SetTrackingRatio(1);
+    windows.clear();
+    online.Push(signal, &windows);
+    report("warm start and tracking", windows);
+    cout << "tracked windows: " << online.GetNumberOfTrackedWindows() << " of " << online.GetNumberOfWindows() << endl;
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <Eigen/Dense>
+#include "OrthonormalHermite.h"
+#include "NelderMead.h"
+#include "VariableProjection.h"
+
+using namespace std;
+
+int main()
+{
+    APPRSDK::VariableProjection<double> approximator;
+    APPRSDK::OrthonormalHermite<double> hermiteSys(100, 10);
+
+    Eigen::RowVectorXd inputParameters(2);
+    inputParameters << 0.7, 50;
+    Eigen::RowVectorXd lb(2), ub(2);
+    lb << 0.01, -1000;
+    ub << 1000, 1000;
+
+    approximator.SetMaxErrorForOptimisation(1e-6);
+    approximator.SetMaxIterationForOptimisation(100);
+    approximator.SetFunctionSystem(&hermiteSys);
+    approximator.SetNonLinParams(inputParameters);
+    approximator.SelectOptimiser(APPRSDK::AvailableOptimizers::NM, true);
+    approximator.SetBoundaries(lb, ub);
+    approximator.SetSignal(hermiteSys.GetFunctionSystem().col(4).transpose());
+
+    const char* names[] = {"no budget", "20 evaluations", "1 ms deadline"};
+    for (int i = 0; i < 3; ++i)
+    {
+        APPRSDK::OptimizationBudget<double> budget;
+        if (i == 1)
+        {
+            budget.SetMaxEvaluations(20);
+        }
+        else if (i == 2)
+        {
+            budget.SetDeadline(0.001);
+        }
+        approximator.SetBudget(budget);
+        approximator.SetNonLinParams(inputParameters);
+        unsigned int evaluations = approximator.GetIterations();
+        approximator.Varpro();
+
+        cout<<names[i]<<": final error "<<approximator.GetError()<<", stop reason "<<approximator.GetStopReason()
+            <<", evaluations "<<approximator.GetIterations() - evaluations<<", fit time "<<approximator.GetFitTime()<<" s"<<endl;
+    }
+
+    return 0;
+}
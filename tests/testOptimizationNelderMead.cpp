@@ -1,8 +1,10 @@
 #include <iostream>
+#include <sstream>
 #include <unistd.h>
 #include <vector>
 
 #include "NelderMead.h"
+#include "StaticApproxStrategy.h"
 
 /*
     Information on test functions: https://en.wikipedia.org/wiki/Test_functions_for_optimization
@@ -86,6 +88,32 @@ class BoothClass : public BaseOptimizable
         }
 };
 
+class StaticBoothClass
+{
+    public:
+        double Evaluate(const ERowVecRef<double>& v)
+        {
+            return ((v(0) + 2*v(1) - 7)*(v(0) + 2*v(1) - 7)) + ((2*v(0) + v(1) -5)*(2*v(0) + v(1) -5));
+        }
+};
+
+class CountingRosenbrockClass
+{
+    public:
+        unsigned int calls;
+
+        CountingRosenbrockClass() : calls(0)
+        {
+
+        }
+
+        double Evaluate(const ERowVecRef<double>& v)
+        {
+            calls++;
+            return (1 - v(0))*(1 - v(0)) + 100*(v(1) - v(0)*v(0))*(v(1) - v(0)*v(0));
+        }
+};
+
 int main()
 {
     const unsigned int longSleep = 3000;
@@ -158,5 +186,101 @@ int main()
     TestNelderMead<double, BoothClass>(inputParameters, BoothObj, 0.0001, 100);
     usleep(longSleep);
 
+    std::cout<<"Optimizing Booth function with the static Nelder-Mead. Expected: (1, 3)"<<std::endl;
+
+    StaticBoothClass staticBoothObj;
+    APPRSDK::StaticNelderMead<double, StaticBoothClass> staticOptimizer;
+    staticOptimizer.Optimize(0.0001, 100, inputParameters, staticBoothObj);
+
+    std::cout<<"Number of iterations: "<<staticOptimizer.GetIterations()<<std::endl;
+    std::cout<<"Final error: "<<staticOptimizer.GetCurrentError()<<std::endl;
+    std::cout<<"Minimum position: "<<staticOptimizer.GetPosition()<<std::endl;
+    usleep(longSleep);
+
+    std::cout<<"Static Nelder-Mead on the Rosenbrock function with evaluation budgets of 1..200. Expected: no budget overrun"<<std::endl;
+
+    Eigen::MatrixXd rosenbrockSimplex(3, 2);
+    rosenbrockSimplex << -1.2, 1, -0.7, 1, -1.2, 1.5;
+    unsigned int overruns = 0;
+    for (unsigned int maxEvaluations = 1; maxEvaluations <= 200; ++maxEvaluations)
+    {
+        CountingRosenbrockClass rosenbrockObj;
+        APPRSDK::StaticNelderMead<double, CountingRosenbrockClass> budgetedOptimizer;
+        APPRSDK::OptimizationBudget<double> rosenbrockBudget;
+        rosenbrockBudget.SetMaxEvaluations(maxEvaluations);
+        budgetedOptimizer.SetBudget(rosenbrockBudget);
+        budgetedOptimizer.Optimize(1e-12, 1000, rosenbrockSimplex, rosenbrockObj);
+        overruns += (rosenbrockObj.calls > maxEvaluations);
+    }
+    std::cout<<"Budgets overrun: "<<overruns<<std::endl;
+
+    Eigen::MatrixXd singleStart(1, 2);
+    singleStart << -1.2, 1;
+    CountingRosenbrockClass rosenbrockObj;
+    APPRSDK::StaticNelderMead<double, CountingRosenbrockClass> rejectingOptimizer;
+    bool started = rejectingOptimizer.Optimize(1e-12, 1000, singleStart, rosenbrockObj);
+    std::cout<<"Single starting point: "<<(started ? "accepted" : "rejected")<<", evaluations: "<<rosenbrockObj.calls<<std::endl;
+    usleep(longSleep);
+
+    std::cout<<"Optimizing Booth function with a budget of 20 evaluations. Expected: stop reason "<<APPRSDK::MaxEvaluationsReached<<std::endl;
+
+    APPRSDK::OptimizationBudget<double> budget;
+    budget.SetMaxEvaluations(20);
+    budget.SetDeadline(0.5);
+
+    APPRSDK::NelderMead<double, BoothClass*> budgetOptimizer;
+    budgetOptimizer.SetBudget(budget);
+    budgetOptimizer.Optimize(0.0001, 100, inputParameters, &BoothObj);
+
+    std::cout<<"Number of evaluations: "<<budgetOptimizer.GetNumberOfEvaluations()<<std::endl;
+    std::cout<<"Stop reason: "<<budgetOptimizer.GetStopReason()<<std::endl;
+    std::cout<<"Elapsed time: "<<budgetOptimizer.GetElapsedTime()<<" s"<<std::endl;
+    std::cout<<"Best error: "<<budgetOptimizer.GetCurrentError()<<std::endl;
+    std::cout<<"Best position: "<<budgetOptimizer.GetPosition()<<std::endl;
+    usleep(longSleep);
+
+    std::cout<<"Saving the interrupted simplex and resuming the optimization from it"<<std::endl;
+
+    std::stringstream checkpoint;
+    budgetOptimizer.GetState().Save(checkpoint);
+    std::cout<<checkpoint.str();
+
+    APPRSDK::OptimizerState<double> state;
+    if (!state.Load(checkpoint))
+    {
+        std::cout<<"Could not load the checkpoint"<<std::endl;
+    }
+
+    APPRSDK::NelderMead<double, BoothClass*> resumedOptimizer;
+    resumedOptimizer.SetState(state, true);
+    resumedOptimizer.Optimize(0.0001, 100, inputParameters, &BoothObj);
+
+    std::cout<<"Number of evaluations: "<<resumedOptimizer.GetNumberOfEvaluations()<<std::endl;
+    std::cout<<"Stop reason: "<<resumedOptimizer.GetStopReason()<<std::endl;
+    std::cout<<"Best error: "<<resumedOptimizer.GetCurrentError()<<std::endl;
+    std::cout<<"Best position: "<<resumedOptimizer.GetPosition()<<std::endl;
+    usleep(longSleep);
+
+    std::cout<<"Loading malformed checkpoints. Expected: all rejected, the empty strategy restored"<<std::endl;
+
+    const char* malformed[] = {"residual 2 3", "residual 1 -2", "values 3 2", "points 100000 100000", "points -1 2"};
+    for (int i = 0; i < 5; ++i)
+    {
+        std::string field(malformed[i]);
+        std::string key = field.substr(0, field.find(' '));
+        std::stringstream corrupted;
+        const char* fields[] = {"points 0 0", "values 0 1", "residual 1 0", "jacobian 0 0", "history 0 0"};
+        corrupted<<"strategy -\niterations 0\ndamping 0\n";
+        for (int j = 0; j < 5; ++j)
+        {
+            corrupted<<((std::string(fields[j]).compare(0, key.size(), key) == 0) ? field : std::string(fields[j]))<<"\n";
+        }
+        std::cout<<malformed[i]<<": "<<(state.Load(corrupted) ? "loaded" : "rejected")<<std::endl;
+    }
+
+    std::stringstream emptyState;
+    APPRSDK::OptimizerState<double>().Save(emptyState);
+    std::cout<<"empty state: "<<(state.Load(emptyState) ? "loaded" : "rejected")<<", strategy \""<<state.strategy<<"\""<<std::endl;
+
     return 0;
 }
\ No newline at end of file
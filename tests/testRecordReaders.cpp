@@ -0,0 +1,159 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include "WfdbReader.h"
+#include "EdfReader.h"
+#include "OrthonormalHermite.h"
+#include "VariableProjection.h"
+
+using namespace std;
+
+// Digital test samples of a channel (12 bit range)
+int testSample(unsigned int channel, unsigned long i)
+{
+    return (int)(800 * sin(i / (50.0 + 10 * channel))) + (int)(i % 7) - 3 + 100 * channel;
+}
+
+// MIT-BIH like record: 3 channels in format 212, gain 200, baseline 1024
+void writeWfdb(const string& name, unsigned int channels, unsigned long length)
+{
+    ofstream header((name + ".hea").c_str());
+    header << "# test record" << endl;
+    header << "test " << channels << " 360 " << length << endl;
+    for (unsigned int c = 0; c < channels; ++c)
+    {
+        header << "test.dat 212 200(1024)/mV 11 0 0 0 0 lead " << c << endl;
+    }
+
+    vector<int> samples;
+    for (unsigned long i = 0; i < length; ++i)
+    {
+        for (unsigned int c = 0; c < channels; ++c)
+        {
+            samples.push_back(testSample(c, i) + 1024);
+        }
+    }
+    samples.push_back(0);
+
+    ofstream data((name + ".dat").c_str(), ios::binary);
+    for (unsigned long i = 0; i + 1 < samples.size(); i += 2)
+    {
+        unsigned char bytes[3] = {(unsigned char)(samples[i] & 0xFF),
+                                  (unsigned char)(((samples[i] >> 8) & 0x0F) | (((samples[i + 1] >> 8) & 0x0F) << 4)),
+                                  (unsigned char)(samples[i + 1] & 0xFF)};
+        data.write((const char*)bytes, 3);
+    }
+}
+
+string edfField(const string& value, unsigned int length)
+{
+    return (value + string(length, ' ')).substr(0, length);
+}
+
+// EDF+ file: 2 channels with 256 samples per 1 s record, 1 annotation signal
+void writeEdf(const string& filename, unsigned long records)
+{
+    const unsigned int signals = 3;
+    const char* labels[] = {"ECG I", "ECG II", "EDF Annotations"};
+    unsigned int samples[] = {256, 256, 30};
+
+    ofstream file(filename.c_str(), ios::binary);
+    file << edfField("0", 8) << edfField("X X X X", 80) << edfField("Startdate X X X X", 80) << "01.01.20" << "00.00.00"
+         << edfField(to_string(256 * (signals + 1)), 8) << edfField("EDF+C", 44) << edfField(to_string(records), 8)
+         << edfField("1", 8) << edfField(to_string(signals), 4);
+    for (unsigned int s = 0; s < signals; ++s) file << edfField(labels[s], 16);
+    for (unsigned int s = 0; s < signals; ++s) file << edfField("", 80);
+    for (unsigned int s = 0; s < signals; ++s) file << edfField("mV", 8);
+    for (unsigned int s = 0; s < signals; ++s) file << edfField("-5", 8);
+    for (unsigned int s = 0; s < signals; ++s) file << edfField("5", 8);
+    for (unsigned int s = 0; s < signals; ++s) file << edfField("-2048", 8);
+    for (unsigned int s = 0; s < signals; ++s) file << edfField("2047", 8);
+    for (unsigned int s = 0; s < signals; ++s) file << edfField("", 80);
+    for (unsigned int s = 0; s < signals; ++s) file << edfField(to_string(samples[s]), 8);
+    for (unsigned int s = 0; s < signals; ++s) file << edfField("", 32);
+
+    for (unsigned long r = 0; r < records; ++r)
+    {
+        for (unsigned int s = 0; s < signals; ++s)
+        {
+            for (unsigned int i = 0; i < samples[s]; ++i)
+            {
+                int16_t value = (s < 2) ? testSample(s, r * samples[s] + i) : 0;
+                file.write((const char*)&value, sizeof(value));
+            }
+        }
+    }
+}
+
+int main()
+{
+    // WFDB format 212, odd number of channels and odd block length (the packed pairs span blocks)
+    const unsigned long length = 650000;
+    writeWfdb("/tmp/test", 3, length);
+
+    APPRSDK::WfdbReader<double> wfdb;
+    bool ok = wfdb.Open("/tmp/test");
+    cout << "WFDB: " << (ok ? "opened" : "failed") << ", channels: " << wfdb.GetNumberOfChannels() << " (" << wfdb.GetChannelName(0)
+         << "), frequency: " << wfdb.GetSamplingFrequency() << ", length: " << wfdb.GetLength() << endl;
+
+    auto start = std::chrono::steady_clock::now();
+    unsigned long position = 0, blocks = 0;
+    double deviation = 0;
+    for (APPRSDK::SampleBlockIterator<double> block(&wfdb, 999), end; block != end; ++block, ++blocks)
+    {
+        for (unsigned int c = 0; c < block->rows(); ++c)
+        {
+            for (long i = 0; i < block->cols(); ++i)
+            {
+                deviation = max(deviation, fabs((*block)(c, i) - testSample(c, position + i) / 200.0));
+            }
+        }
+        position += block->cols();
+    }
+    double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    cout << "WFDB: blocks: " << blocks << ", samples: " << position << ", max deviation: " << deviation << ", time: " << time << " s" << endl;
+
+    // EDF+, the annotation signal is skipped
+    writeEdf("/tmp/test.edf", 60);
+    APPRSDK::EdfReader<double> edf;
+    ok = edf.Open("/tmp/test.edf");
+    cout << "EDF: " << (ok ? "opened" : "failed") << ", signals: " << edf.GetNumberOfSignals() << ", channels: " << edf.GetNumberOfChannels()
+         << " (" << edf.GetChannelName(0) << ", " << edf.GetChannelName(1) << "), frequency: " << edf.GetSamplingFrequency()
+         << ", length: " << edf.GetLength() << endl;
+
+    position = 0;
+    blocks = 0;
+    deviation = 0;
+    for (APPRSDK::SampleBlockIterator<double> block(&edf, 300), end; block != end; ++block, ++blocks)
+    {
+        for (unsigned int c = 0; c < block->rows(); ++c)
+        {
+            for (long i = 0; i < block->cols(); ++i)
+            {
+                deviation = max(deviation, fabs((*block)(c, i) - (testSample(c, position + i) + 2048) * 10.0 / 4095 + 5));
+            }
+        }
+        position += block->cols();
+    }
+    cout << "EDF: blocks: " << blocks << ", samples: " << position << ", max deviation: " << deviation << endl;
+
+    // A channel of a block is handed to the approximator without conversion
+    edf.Rewind();
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> block;
+    edf.ReadBlock(block, 256);
+    APPRSDK::VariableProjection<double> approximator;
+    approximator.SetSignal(block.row(1));
+    cout << "signal of the approximator: " << approximator.GetSignal().cols() << " samples" << endl;
+
+    remove("/tmp/test.hea");
+    remove("/tmp/test.dat");
+    remove("/tmp/test.edf");
+
+    return 0;
+}
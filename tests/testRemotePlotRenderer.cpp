@@ -0,0 +1,80 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <Eigen/Dense>
+#include "RemotePlotRenderer.h"
+
+using namespace std;
+
+// Renders a QA plot (signal and approximation) per beat, with one worker process per thread
+void renderBeats(unsigned int thread, unsigned int beats, int& errors)
+{
+    APPRSDK::RemotePlotRenderer renderer;
+    if (!renderer.Start())
+    {
+        errors = -1;
+        return;
+    }
+
+    Eigen::RowVectorXd x = Eigen::RowVectorXd::LinSpaced(400, 0, 399);
+    for (unsigned int beat = 0; beat < beats; ++beat)
+    {
+        Eigen::RowVectorXd approximation = (-(x.array() - 200).square() / 200.0).exp().matrix();
+        Eigen::RowVectorXd signal = approximation + Eigen::RowVectorXd::Random(400) * 0.05;
+
+        ostringstream filename;
+        filename << "/tmp/remotePlotRenderer_" << thread << "_" << beat << ".png";
+
+        renderer.Figure(640, 480);
+        renderer.Plot(x, signal, "b-", "signal");
+        renderer.Plot(x, ERowVec<double>(approximation), "r--", "approximation");
+        renderer.Plot(x.head(100), (signal - approximation).head(100), "g:", "residual");
+        renderer.Title("beat " + to_string(beat));
+        renderer.Legend();
+        renderer.Grid(true);
+        // An infinite limit is sent as null, i.e. the top stays autoscaled
+        renderer.YLim(-0.5, numeric_limits<double>::infinity());
+        renderer.Save(filename.str());
+        renderer.Close();
+    }
+
+    errors = renderer.Sync();
+}
+
+int main()
+{
+    const unsigned int threads = 4;
+    const unsigned int beats = 8;
+
+    vector<int> errors(threads, 0);
+    vector<thread> pool;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < threads; ++i)
+    {
+        pool.push_back(thread(renderBeats, i, beats, std::ref(errors[i])));
+    }
+    for (unsigned int i = 0; i < threads; ++i)
+    {
+        pool[i].join();
+    }
+    double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (unsigned int i = 0; i < threads; ++i)
+    {
+        if (errors[i] < 0)
+        {
+            cout << "thread " << i << ": the plot worker is not available (python3 with matplotlib and numpy is needed)" << endl;
+        }
+        else
+        {
+            cout << "thread " << i << ": " << beats << " beats rendered, failed commands: " << errors[i] << endl;
+        }
+    }
+    cout << "rendering time: " << time << " s" << endl;
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <Eigen/Dense>
+#include "OrthonormalHermite.h"
+#include "NelderMead.h"
+#include "SequentialFitter.h"
+
+using namespace std;
+
+const unsigned int m = 100;
+
+// Beats of one patient with a small jitter; the morphology changes at beat 30
+Eigen::RowVectorXd testBeat(unsigned int i)
+{
+    double jitter = 2.0 * rand() / RAND_MAX - 1;
+    Eigen::RowVectorXd beat = Eigen::RowVectorXd::Random(m) * 0.02;
+    for (unsigned int j = 0; j < m; ++j)
+    {
+        double t = j - 50.0 - jitter;
+        if (i < 30)
+        {
+            beat(j) += exp(-t * t / (50.0 + 5 * jitter)) - 0.3 * exp(-(t - 8) * (t - 8) / 20.0);
+        }
+        else
+        {
+            beat(j) += -0.8 * exp(-(t + 10) * (t + 10) / 150.0) + 0.4 * exp(-(t - 15) * (t - 15) / 40.0);
+        }
+    }
+    return beat;
+}
+
+int main()
+{
+    APPRSDK::VariableProjection<double> approximator;
+    APPRSDK::OrthonormalHermite<double> hermiteSys(m, 7);
+    Eigen::RowVectorXd lb(2), ub(2);
+    lb << 0.01, 0;
+    ub << 2, m;
+    approximator.SetMaxErrorForOptimisation(0.001);
+    approximator.SetMaxIterationForOptimisation(100);
+    approximator.SetFunctionSystem(&hermiteSys);
+
+    // Nelder-Mead stops when the simplex has converged, so a start close to the optimum saves iterations
+    APPRSDK::NelderMead<double, APPRSDK::VariableProjection<double>* > optimizer;
+    optimizer.SetSimplexTolerances(0.001, 0.0001);
+    approximator.SetOptimiser(&optimizer);
+    approximator.SetBoundaries(lb, ub);
+
+    Eigen::MatrixXd initial(3, 2);
+    initial << 0.1, m / 2.0, 0.15, m / 2.0, 0.1, m / 2.0 + 5;
+
+    APPRSDK::SequentialFitter<double> fitter(&approximator);
+    cout << "fit without initial parameters: " << (fitter.Fit(testBeat(0)) ? "fitted" : "refused") << endl;
+    fitter.SetInitialParameters(initial);
+
+    const unsigned int beats = 60;
+    for (int chained = 0; chained < 2; ++chained)
+    {
+        srand(1);
+        fitter.Reset();
+        double error = 0;
+        for (unsigned int i = 0; i < beats; ++i)
+        {
+            if (!chained)
+            {
+                // Every beat cold; the statistics are accumulated over all beats
+                fitter.ResetChain();
+            }
+            fitter.Fit(testBeat(i));
+            error += approximator.GetError();
+            if (fitter.WasReset())
+            {
+                cout << "morphology change detected at beat " << i << endl;
+            }
+        }
+        cout << (chained ? "chained" : "cold") << ": mean evaluations: " << fitter.GetMeanEvaluations() << ", mean error: " << error / beats
+             << ", warm starts: " << fitter.GetNumberOfWarmStarts() << ", resets: " << fitter.GetNumberOfResets() << endl;
+    }
+
+    // Continuing from the simplex of the previous beat
+    srand(1);
+    fitter.Reset();
+    fitter.SetReuseOptimizerState(true);
+    double error = 0;
+    for (unsigned int i = 0; i < beats; ++i)
+    {
+        fitter.Fit(testBeat(i));
+        error += approximator.GetError();
+    }
+    cout << "chained with optimizer state: mean evaluations: " << fitter.GetMeanEvaluations() << ", mean error: " << error / beats
+         << ", resets: " << fitter.GetNumberOfResets() << endl;
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <Eigen/Dense>
+#include "SignalLoader.h"
+
+using namespace std;
+
+Eigen::RowVectorXd loadWithStream(const char* filename)
+{
+    ifstream file(filename);
+    vector<double> samples;
+    double value;
+    while (file >> value)
+    {
+        samples.push_back(value);
+    }
+    return Eigen::Map<Eigen::RowVectorXd>(samples.data(), samples.size());
+}
+
+int main()
+{
+    APPRSDK::SignalLoader<double> loader;
+    cout << "threads: " << loader.GetNumberOfThreads() << endl;
+
+    // The test record, compared with the iostream parsing
+    Eigen::RowVectorXd ecg;
+    bool ok = loader.LoadText("ecg.txt", ecg);
+    Eigen::RowVectorXd reference = loadWithStream("ecg.txt");
+    cout << "ecg.txt: " << (ok ? "loaded" : "failed") << ", samples: " << ecg.cols() << " / " << reference.cols()
+         << ", max deviation: " << (ecg - reference).cwiseAbs().maxCoeff() << endl;
+
+    // A long record with 6 decimals (1e7 samples)
+    const char* textFile = "/tmp/signalLoaderTest.txt";
+    const char* binaryFile = "/tmp/signalLoaderTest.bin";
+    Eigen::RowVectorXd record = Eigen::RowVectorXd::Random(10000000) * 3;
+    FILE* file = fopen(textFile, "w");
+    for (long i = 0; i < record.cols(); ++i)
+    {
+        fprintf(file, "%f\n", record(i));
+    }
+    fclose(file);
+
+    auto start = std::chrono::steady_clock::now();
+    reference = loadWithStream(textFile);
+    double streamTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Eigen::RowVectorXd signal;
+    start = std::chrono::steady_clock::now();
+    ok = loader.LoadText(textFile, signal);
+    double loaderTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    cout << "text: " << (ok ? "loaded" : "failed") << ", samples: " << signal.cols() << ", differing samples: "
+         << (signal.array() != reference.array()).count() << endl;
+    cout << "iostream: " << streamTime << " s, SignalLoader: " << loaderTime << " s" << endl;
+
+    // The chunking does not change the result
+    APPRSDK::SignalLoader<double> chunkedLoader(4);
+    Eigen::RowVectorXd chunked;
+    chunkedLoader.LoadText(textFile, chunked);
+    cout << "4 chunks: samples: " << chunked.cols() << ", differing samples: " << (chunked.array() != signal.array()).count() << endl;
+
+    // Column vector, float
+    APPRSDK::SignalLoader<float> floatLoader;
+    Eigen::VectorXf column;
+    floatLoader.LoadText("ecg.txt", column);
+    cout << "float column: " << column.rows() << " x " << column.cols() << ", max deviation: "
+         << (column.cast<double>().transpose() - ecg).cwiseAbs().maxCoeff() << endl;
+
+    // Binary format
+    APPRSDK::SignalLoader<double>::SaveBinary(binaryFile, signal);
+    start = std::chrono::steady_clock::now();
+    ok = loader.OpenBinary(binaryFile);
+    Eigen::Map<const Eigen::RowVectorXd> mapped = loader.GetSignal();
+    double sum = mapped.sum();
+    double binaryTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    cout << "binary: " << (ok ? "mapped" : "failed") << ", samples: " << mapped.cols() << ", equal: " << (mapped == signal)
+         << ", open and sum: " << binaryTime << " s (sum " << sum << ")" << endl;
+    cout << "opened as float: " << floatLoader.OpenBinary(binaryFile) << endl;
+
+    // A file of another version of the format
+    loader.Close();
+    file = fopen(binaryFile, "r+b");
+    fseek(file, 8, SEEK_SET);
+    uint32_t version = 2;
+    fwrite(&version, sizeof(version), 1, file);
+    fclose(file);
+    cout << "version 2: " << (loader.OpenBinary(binaryFile) ? "mapped" : "rejected") << endl;
+
+    // Numbers longer than the buffer of the strtod fallback
+    file = fopen(textFile, "w");
+    fprintf(file, "1.5\n0.%070d1\n-2.%080d\n", 0, 0);
+    fclose(file);
+    ok = loader.LoadText(textFile, signal);
+    cout << "long numbers: " << (ok ? "loaded" : "rejected") << ", values: " << signal << endl;
+
+    // Malformed input
+    file = fopen(textFile, "w");
+    fprintf(file, "1.5\n2.5\nabc\n");
+    fclose(file);
+    cout << "malformed: " << (loader.LoadText(textFile, signal) ? "loaded" : "rejected") << endl;
+
+    remove(textFile);
+    loader.Close();
+    remove(binaryFile);
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <Eigen/Dense>
+#include "SnapshotQueue.h"
+
+using namespace std;
+
+int main()
+{
+    // A fast producer (the optimizer) and a slow consumer (the plot): the producer never waits
+    APPRSDK::SnapshotQueue<Eigen::RowVectorXd> queue(4);
+    std::atomic<bool> producing(true);
+    unsigned long pushed = 0;
+    unsigned long popped = 0;
+
+    std::thread consumer([&]()
+    {
+        Eigen::RowVectorXd frame;
+        while (true)
+        {
+            if (queue.TryPopLatest(frame))
+            {
+                popped++;
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+            else if (!producing.load())
+            {
+                break;
+            }
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 2000; ++i)
+    {
+        // One "evaluation" of the optimizer
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+        Eigen::RowVectorXd* slot = queue.BeginPush();
+        if (slot != 0)
+        {
+            slot->setConstant(1000, i);
+            queue.EndPush();
+            pushed++;
+        }
+    }
+    double producerTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    producing.store(false);
+    consumer.join();
+
+    cout << "producer time: " << producerTime << " s" << endl;
+    cout << "pushed: " << pushed << endl;
+    cout << "popped: " << popped << endl;
+    cout << "dropped: " << queue.GetDropped() << endl;
+
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include <iostream>
+#include <Eigen/Dense>
+#include "OrthonormalHermite.h"
+#include "NelderMead.h"
+#include "VariableProjection.h"
+#include "StaticApproxStrategy.h"
+
+using namespace std;
+
+int main()
+{
+    APPRSDK::VariableProjection<double> approximator;
+    APPRSDK::OrthonormalHermite<double> hermiteSys(100, 10);
+    APPRSDK::StaticNelderMead<double, APPRSDK::VariableProjection<double> > staticOptimizer;
+
+    Eigen::RowVectorXd inputParameters(2);
+    inputParameters << 0.7, 50;
+
+    approximator.SetMaxErrorForOptimisation(0.01);
+    approximator.SetMaxIterationForOptimisation(100);
+    approximator.SetFunctionSystem(&hermiteSys);
+    approximator.SetNonLinParams(inputParameters);
+    approximator.SelectOptimiser(APPRSDK::AvailableOptimizers::NM, true);
+    approximator.SetSignal(hermiteSys.GetFunctionSystem().col(4).transpose());
+    // Without the cache both strategies pay for every evaluation
+    approximator.SetCacheOptions(0, 0);
+
+    approximator.SetNonLinParams(inputParameters);
+    approximator.Varpro();
+    cout<<"virtual Nelder-Mead: dilatation & translation "<<approximator.GetNonLinearParameters()<<", final error "<<approximator.GetError()
+        <<", fit time "<<approximator.GetFitTime()<<" s"<<endl;
+
+    approximator.SetNonLinParams(inputParameters);
+    approximator.Varpro(staticOptimizer);
+    cout<<"static Nelder-Mead: dilatation & translation "<<approximator.GetNonLinearParameters()<<", final error "<<approximator.GetError()
+        <<", fit time "<<approximator.GetFitTime()<<" s"<<endl;
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <iostream>
+#include <Eigen/Dense>
+#include "OrthonormalHermite.h"
+#include "VariableProjection.h"
+
+using namespace std;
+
+// Central differences of the weighted residual W(signal - approximation) (the weights are the identity)
+Eigen::MatrixXd numericalJacobian(APPRSDK::VariableProjection<double>& approximator, const Eigen::RowVectorXd& parameters, double step)
+{
+    Eigen::MatrixXd ret(approximator.GetSignal().cols(), parameters.cols());
+    for (int j = 0; j < parameters.cols(); ++j)
+    {
+        Eigen::RowVectorXd forward = parameters, backward = parameters;
+        forward(j) += step;
+        backward(j) -= step;
+
+        approximator.Evaluate(forward);
+        Eigen::RowVectorXd residualForward = approximator.GetSignal() - approximator.GetApproximation();
+        approximator.Evaluate(backward);
+        Eigen::RowVectorXd residualBackward = approximator.GetSignal() - approximator.GetApproximation();
+
+        ret.col(j) = (residualForward - residualBackward).transpose() / (2 * step);
+    }
+    return ret;
+}
+
+int main()
+{
+    APPRSDK::VariableProjection<double> approximator;
+    APPRSDK::OrthonormalHermite<double> hermiteSys(100, 6);
+
+    // Two Hermite functions and noise, so the residual (and with it the second Kaufman term) is not zero
+    Eigen::RowVectorXd parameters(2);
+    parameters << 0.2, 50;
+    hermiteSys.ApplyNonLinearParameters(parameters);
+    Eigen::RowVectorXd signal = 0.8 * hermiteSys.GetFunctionSystem().col(2).transpose() + 0.3 * hermiteSys.GetFunctionSystem().col(4).transpose();
+    signal += 0.05 * Eigen::RowVectorXd::Random(signal.cols());
+
+    approximator.SetFunctionSystem(&hermiteSys);
+    approximator.SetSignal(signal);
+
+    Eigen::RowVectorXd point(2);
+    point << 0.23, 47;
+    double error = approximator.Evaluate(point);
+    Eigen::RowVectorXd residual = approximator.GetSignal() - approximator.GetApproximation();
+    Eigen::MatrixXd jacobian = approximator.GetJacobian();
+    Eigen::MatrixXd numerical = numericalJacobian(approximator, point, 1e-6);
+
+    cout << "error: " << error << ", norm of the residual: " << residual.norm() << endl;
+    cout << "Jacobian (analytic | central differences):" << endl;
+    for (int i = 40; i < 50; ++i)
+    {
+        cout << jacobian.row(i) << "\t|\t" << numerical.row(i) << endl;
+    }
+    cout << "relative deviation from central differences: " << (jacobian - numerical).norm() / numerical.norm() << endl;
+
+    return 0;
+}